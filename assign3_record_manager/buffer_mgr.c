@@ -1,625 +1,3581 @@
 #include "stdio.h"
 #include "stdlib.h"
 #include "string.h"
+#include "limits.h"
+#include "pthread.h"
+#include "time.h"
+#include "errno.h"
+#include "sys/mman.h"
 
 #include "buffer_mgr.h"
 #include "storage_mgr.h"
 
+// number of independently latched partitions of the page table, a power of two
+#define BM_PAGE_TABLE_PARTITIONS 16
+
+// size the frame arena is rounded up to when it is backed by huge pages
+#define BM_HUGE_PAGE_SIZE ((size_t)2 << 20)
+
+// page ranges prefetchPages keeps waiting for the prefetcher, and completions it takes from the async engine at once
+#define BM_PREFETCH_QUEUE 16
+#define BM_PREFETCH_COMPLETIONS 16
+
+// warm-up list of a page file: <page file><BM_WARMUP_SUFFIX>, a WarmUpHeader followed by count page numbers
+#define BM_WARMUP_SUFFIX ".warm"
+#define BM_WARMUP_MAGIC 0x4D524157 // "WARM"
+
+// page files a pool can have open at once, its own file (id 0) included
+#define BM_MAX_PAGE_FILES 64
+
+// frames, page tables and strategies know a page by its key: the id of its page file above BM_FILE_ID_SHIFT, its page number below;
+// the keys of the pool's own file (id 0) are its page numbers
+#define BM_FILE_ID_SHIFT 40
+#define PAGE_KEY(fileId, pageNum) (((PageNumber)(fileId) << BM_FILE_ID_SHIFT) | (pageNum))
+#define KEY_FILE_ID(key) ((int)((key) >> BM_FILE_ID_SHIFT))
+#define KEY_PAGE_NUMBER(key) ((key) & (((PageNumber)1 << BM_FILE_ID_SHIFT) - 1))
+
 // Creating structure to store buffer frame
+// The fix count, dirty flag and reference bit are atomic, hits update them without the pool latch.
+// latch is held exclusively while the frame is loaded with a page, shared while its page is written out.
 typedef struct BufferFrame
 {
 	struct BufferFrame *prevFrame;
-	int dirtyFlag;
+	_Atomic int dirtyFlag;
 	struct BufferFrame *nextFrame;
-	int pageNumber;
-	int count;
+	_Atomic PageNumber pageNumber; // key of the page in the frame
+	_Atomic int count;
 	char *data;
-	int refBit;
+	_Atomic int refBit;
+	pthread_rwlock_t latch;
+	_Atomic int loading;	 // set while the frame is claimed and its I/O is not done
+	PageNumber previousPage; // page the frame held when it was claimed for a new one
+	RC ioResult;			 // why the last load of the frame failed
+	_Atomic int prefetched;	 // loaded by prefetchPages and not pinned since
+	_Atomic int inRing;		 // loaded through a scan ring and not pinned by another caller since
+	struct LFUBucket *bucket;
+	struct BufferFrame *bucketPrev;
+	struct BufferFrame *bucketNext;
+	int64_t *history;
+	int64_t lastReference;
+	struct ARCList *arcList;
+	struct BufferFrame *arcPrev;
+	struct BufferFrame *arcNext;
 } BufferFrame;
 
+// Frequency bucket of the LFU strategy, holds the frames referenced equally often
+typedef struct LFUBucket
+{
+	int frequency;
+	BufferFrame *first; // most recently used frame
+	BufferFrame *last;	// least recently used frame, replaced first
+	struct LFUBucket *prevBucket;
+	struct LFUBucket *nextBucket;
+} LFUBucket;
+
+// One of the lists of the ARC strategy, most recently used entry first
+typedef struct ARCList
+{
+	BufferFrame *first;
+	BufferFrame *last;
+	int size;
+} ARCList;
+
+// Slot of a page table; keyed by page number, so a frame can stay listed under the page it is still writing back
+typedef struct PageTableEntry
+{
+	PageNumber pageNumber;
+	BufferFrame *frame;
+} PageTableEntry;
+
+// Open-addressing hash table from page numbers to frames
+typedef struct PageTable
+{
+	PageTableEntry *slots;
+	int bits;
+	int count;
+} PageTable;
+
+// One partition of the pool's page table with the latch guarding it
+typedef struct PageTablePartition
+{
+	pthread_mutex_t latch;
+	PageTable table;
+} PageTablePartition;
+
+// Page range waiting for the prefetcher
+typedef struct PrefetchRequest
+{
+	PageNumber startPage; // key of the first page
+	int count;
+	BM_ScanRing *ring; // ring the pages are loaded into, NULL for the whole pool
+	PageNumber *pages; // sorted keys of a warm-up, loaded run by run instead of the range (startPage is the first); freed with the request
+} PrefetchRequest;
+
+// start of a warm-up list
+typedef struct WarmUpHeader
+{
+	uint32_t magic;
+	int32_t count;
+} WarmUpHeader;
+
+// Frames of a bulk-read scan ring; slot i holds the frame it loaded last and the page it loaded into it
+typedef struct ScanRing
+{
+	BufferFrame **frames;
+	PageNumber *pages; // keys
+	int next;		   // slot the next miss of the scan recycles
+} ScanRing;
+
+// Read of one page by the prefetcher into a claimed frame
+typedef struct PrefetchLoad
+{
+	BufferFrame *frame;
+	PageNumber pageNumber;
+	PageNumber oldPage;
+	bool done;
+} PrefetchLoad;
+
+// Reference times of a page evicted from an LRU-K pool, kept in case it comes back
+typedef struct LRUKHistoryEntry
+{
+	PageNumber pageNumber;
+	int64_t lastReference;
+	int64_t *history;
+} LRUKHistoryEntry;
+
+// Frames added to a pool at once, by initBufferPool or by a resizeBufferPool that grew it
+// The descriptors and the page data stay where they are until shutdownBufferPool, so a pinned page never moves
+typedef struct FrameSegment
+{
+	BufferFrame *frames; // dense array of the descriptors
+	char *arena;		 // data of the frames, frame i at arena + i * pageSize
+	size_t arenaSize;
+	int numFrames;
+	LFUBucket *lfuBuckets; // buckets, ghosts and history the frames of a grown segment add to the strategy
+	BufferFrame *arcGhosts;
+	int64_t *lrukHistory;
+	struct FrameSegment *next;
+} FrameSegment;
+
 // Creating structure to store buffer manager with buffer frame, number of read and write etc
+// poolLatch guards the replacement strategy's state and is held while a miss picks its frame, never during I/O.
+// ioEngineLatch makes one thread at a time the user of the file handle's async engine and of writeBackPage.
+// flushLatch guards the flusher's stop flag and requests; the flusher sleeps on flushCond between its rounds.
+// prefetchLatch guards the prefetch queue, the prefetcher sleeps on prefetchCond while it is empty.
+// prefetchIdle is signalled whenever the prefetcher is done with a request, shutdownScanRing and detachPageFile wait for it.
+// filesLatch guards the table of page files against attachPageFile and detachPageFile; threads that have a page of a file
+// pinned or latched use its handle without it.
+// framesLatch guards the frame table: resizeBufferPool holds it exclusively, and the pool latch as well while it changes
+// the table; threads walking the frames without the pool latch hold it shared.
 typedef struct BufferManager
 {
 	BufferFrame *head, *start, *tail;
-	int numRead;
-	int numWrite;
-	SM_FileHandle *smFileHandle;
+	BufferFrame **frames;	  // the pool's frames, the stats list them in this order
+	int frameCapacity;		  // frames the table has room for
+	FrameSegment *segments;	  // where the descriptors and data of the frames live
+	BufferFrame *spareFrames; // frames a shrink took out of the pool, linked by nextFrame; a grow takes them first
+	int hugePages;
+	_Atomic int numRead;
+	_Atomic int numWrite;
+	_Atomic int64_t numHits; // counters reported by getPoolStats
+	_Atomic int64_t numMisses;
+	_Atomic int64_t numPrefetchHits;
+	_Atomic int64_t numCleanEvictions;
+	_Atomic int64_t numDirtyEvictions;
+	_Atomic int64_t numEvictionWrites;
+	_Atomic int64_t numFlushWrites;
+	_Atomic int64_t numPinWaits;
+	_Atomic int64_t pinWaitMicros;
+	_Atomic int numFrames;
+	_Atomic int numDirty; // frames whose dirty flag is set
+	SM_FileHandle *files[BM_MAX_PAGE_FILES]; // open page files by file id, NULL if unused; 0 is the pool's own file
+	char *warmUpFiles[BM_MAX_PAGE_FILES];	 // warm-up list of each open file if the pool keeps them, else NULL
+	int warmUp;
+	SM_IOMode ioMode;						 // I/O backend and async queue depth attached files are opened with
+	int ioQueueDepth;
 	int count;
 	void *strategyData;
+	char *writeBackPage;
+	bool writeBackPending;
+	int pageSize;
+	pthread_mutex_t poolLatch;
+	pthread_mutex_t ioEngineLatch;
+	pthread_mutex_t filesLatch;
+	pthread_rwlock_t framesLatch;
+	PageTablePartition pageTable[BM_PAGE_TABLE_PARTITIONS];
+	pthread_t flusher;
+	bool flusherRunning;
+	bool flusherStop;
+	_Atomic int flushRequested;
+	pthread_mutex_t flushLatch;
+	pthread_cond_t flushCond;
+	int flushInterval;			 // milliseconds between two rounds of the flusher
+	int dirtyHighRatio;			 // the options' dirty ratios, turned into frame counts again when the pool is resized
+	int dirtyLowRatio;
+	_Atomic int dirtyHighFrames; // dirty frames above which markDirty wakes the flusher
+	_Atomic int dirtyLowFrames;	 // dirty frames a round of the flusher leaves
+	pthread_t prefetcher;
+	bool prefetcherRunning;
+	bool prefetcherStop;
+	pthread_mutex_t prefetchLatch;
+	pthread_cond_t prefetchCond;
+	pthread_cond_t prefetchIdle;
+	BM_ScanRing *prefetchRing; // ring of the range the prefetcher is loading
+	int prefetchFileId;		   // file of the range the prefetcher is loading, -1 while it waits
+	PrefetchRequest prefetchQueue[BM_PREFETCH_QUEUE];
+	int prefetchHead;
+	int prefetchCount;
+	BufferFrame *clockHand;
+	int64_t clockSecondChances; // strategy counters, guarded by the pool latch like the rest of the strategy's state
+	LFUBucket *lfuBuckets;
+	LFUBucket *lfuLowest;
+	LFUBucket *lfuFreeBuckets;
+	int lfuAgingInterval;
+	int lfuPins;
+	int64_t lfuAgings;
+	int lrukK;
+	int lrukCorrelatedPeriod;
+	int64_t lrukClock;
+	int64_t *lrukFrameHistory;
+	LRUKHistoryEntry *lrukRetained;
+	int64_t *lrukRetainedHistory;
+	int lrukRetainedSize;
+	int lrukRetainedNext;
+	int *lrukRetainedSlots; // open-addressing index of the retained entries by page number, -1 in empty slots
+	int lrukRetainedBits;
+	int64_t lrukRetainedHits; // pages loaded again whose retained reference times were restored
+	ARCList arcT1, arcT2; // resident pages seen once / more than once recently
+	ARCList arcB1, arcB2; // ghosts: page numbers recently replaced from T1 / T2
+	ARCList arcFree;	  // frames that never held a page
+	int arcTarget;		  // adaptive target size of T1
+	int64_t arcB1Hits;	  // misses on a ghost of B1 / B2
+	int64_t arcB2Hits;
+	BufferFrame *arcGhosts;
+	BufferFrame *arcFreeGhosts;
+	PageTable arcGhostTable;
 } BufferManager;
 
-/*1. This method is used to assign frame values such as previous frame, next frame, tail, head
-2. Takes BufferManger and BufferFrame as the input
-3. Assigns values to the frame and buffer manager
+// multiplier of the page table's Fibonacci hash (2^64 / golden ratio)
+#define PAGE_TABLE_HASH_MULTIPLIER 0x9E3779B97F4A7C15ULL
+
+/*
+1. This method maps a page number to its home slot in a page table
+2. The table has 2^bits slots, the top bits of the product are used
 */
-void AssignBufferManagerValues(BufferManager *bufferManager, BufferFrame *frame)
-{ // define head as start of buffer
-	bufferManager->head = bufferManager->start;
-	// case that head has a value
-	if (bufferManager->head != NULL)
-	{ // case frame has a value
-		if (frame != NULL)
-		{
-			// assigns values to frame and manager
-			bufferManager->tail->nextFrame = frame;
-			frame->prevFrame = bufferManager->tail;
-			bufferManager->tail = bufferManager->tail->nextFrame;
-		}
+int pageTableSlot(PageTable *table, PageNumber pageNum)
+{
+	return (int)(((uint64_t)pageNum * PAGE_TABLE_HASH_MULTIPLIER) >> (64 - table->bits));
+}
+
+/*
+1. This method allocates a page table for up to numEntries pages
+2. Open addressing with linear probing, sized to a power of two at least twice the number of entries
+3. Returns false if the table could not be allocated
+*/
+bool createPageTable(PageTable *table, int numEntries)
+{
+	int bits = 1;
+	while (bits < 30 && (1 << bits) < 2 * numEntries)
+		bits++;
+	table->bits = bits;
+	table->count = 0;
+	table->slots = (PageTableEntry *)calloc((size_t)1 << bits, sizeof(PageTableEntry));
+	return (table->slots == NULL) ? false : true;
+}
+
+/*
+1. This method looks up the frame listed under pageNum
+2. Returns NULL if the page is not in the table
+*/
+BufferFrame *pageTableFind(PageTable *table, PageNumber pageNum)
+{
+	int mask = (1 << table->bits) - 1;
+	int slot = pageTableSlot(table, pageNum);
+	PageTableEntry *entry;
+	// probe until an empty slot ends the cluster
+	while ((entry = &table->slots[slot])->frame != NULL)
+	{
+		if (entry->pageNumber == pageNum)
+			return entry->frame;
+		slot = (slot + 1) & mask;
 	}
-	// case head has no value
-	else
+	return NULL;
+}
+
+/*
+1. This method puts an entry into the first free slot of its probe sequence, the table must have one
+*/
+void pageTablePlace(PageTable *table, PageNumber pageNum, BufferFrame *frame)
+{
+	int mask = (1 << table->bits) - 1;
+	int slot = pageTableSlot(table, pageNum);
+	while (table->slots[slot].frame != NULL)
+		slot = (slot + 1) & mask;
+	table->slots[slot].pageNumber = pageNum;
+	table->slots[slot].frame = frame;
+	table->count++;
+}
+
+/*
+1. This method lists frame in the page table under pageNum
+2. The table doubles once it is half full; if that allocation fails it keeps filling up and only a full table refuses the entry
+3. Returns false if the entry could not be added
+*/
+bool pageTableInsert(PageTable *table, PageNumber pageNum, BufferFrame *frame)
+{
+	PageTable grown;
+	if (2 * (table->count + 1) > (1 << table->bits) && table->bits < 30 && createPageTable(&grown, 1 << table->bits))
 	{
-		if (frame != NULL)
+		int i;
+		for (i = 0; i < (1 << table->bits); i++)
+			if (table->slots[i].frame != NULL)
+				pageTablePlace(&grown, table->slots[i].pageNumber, table->slots[i].frame);
+		free(table->slots);
+		*table = grown;
+	}
+	// one slot always stays empty to end the probes
+	if (table->count + 1 >= (1 << table->bits))
+		return false;
+	pageTablePlace(table, pageNum, frame);
+	return true;
+}
+
+/*
+1. This method removes the entry listing frame under pageNum, if there is one
+2. Later entries of the probe cluster are shifted back into the hole, so lookups never need tombstones
+*/
+void pageTableRemove(PageTable *table, PageNumber pageNum, BufferFrame *frame)
+{
+	int mask = (1 << table->bits) - 1;
+	int hole = pageTableSlot(table, pageNum);
+	int slot;
+	while (table->slots[hole].frame != NULL && table->slots[hole].pageNumber != pageNum)
+		hole = (hole + 1) & mask;
+	if (table->slots[hole].frame != frame || frame == NULL)
+		return;
+	table->slots[hole].frame = NULL;
+	table->count--;
+	for (slot = (hole + 1) & mask; table->slots[slot].frame != NULL; slot = (slot + 1) & mask)
+	{
+		int home = pageTableSlot(table, table->slots[slot].pageNumber);
+		// the entry may move to the hole unless its home lies cyclically in (hole, slot]
+		if (((slot - home) & mask) >= ((slot - hole) & mask))
 		{
-			bufferManager->head = frame;
-			bufferManager->tail = bufferManager->head;
-			bufferManager->start = bufferManager->tail;
+			table->slots[hole] = table->slots[slot];
+			table->slots[slot].frame = NULL;
+			hole = slot;
 		}
 	}
-	// iterate through
-	bufferManager->tail->nextFrame = bufferManager->head;
-	bufferManager->head->prevFrame = bufferManager->tail;
 }
 
 /*
-Different approach: External method to be used within initbufferpool
-1. This method creates the buffer frame from the buffer manager
-2. dirty flag, count, pagenumber and frames will be initialized
+1. This method returns the partition of the pool's page table responsible for pageNum
+2. The low bits of the hash pick the partition, the top bits the slot inside it
 */
-void createBufferFrame(BufferManager *bufferManager)
+PageTablePartition *pageTablePartition(BufferManager *bufferManager, PageNumber pageNum)
 {
-	int i = 0;
-	int pn = -1;
-	BufferFrame *frame = (BufferFrame *)malloc(sizeof(BufferFrame));
-	char *calldata = calloc(PAGE_SIZE, sizeof(char *));
-	frame->data = calldata;
-	// counts num of dirty flags
-	if (i == 0)
+	return &bufferManager->pageTable[((uint64_t)pageNum * PAGE_TABLE_HASH_MULTIPLIER) & (BM_PAGE_TABLE_PARTITIONS - 1)];
+}
+
+/*
+1. This method sets up the latched partitions of the page table of a pool of numPages frames
+2. Each partition starts with room for an even share of the pages and grows if it gets more
+3. Returns false if a partition could not be allocated
+*/
+bool createPageTablePartitions(BufferManager *bufferManager, int numPages)
+{
+	bool created = true;
+	int i;
+	for (i = 0; i < BM_PAGE_TABLE_PARTITIONS; i++)
 	{
-		frame->dirtyFlag = i;
-		frame->count = i;
+		pthread_mutex_init(&bufferManager->pageTable[i].latch, NULL);
+		if (!createPageTable(&bufferManager->pageTable[i].table, numPages / BM_PAGE_TABLE_PARTITIONS + 1))
+			created = false;
 	}
-	if (pn == -1)
+	return created;
+}
+
+/*
+1. This method frees the page table partitions and their latches
+*/
+void freePageTablePartitions(BufferManager *bufferManager)
+{
+	int i;
+	for (i = 0; i < BM_PAGE_TABLE_PARTITIONS; i++)
 	{
-		frame->pageNumber = pn;
+		pthread_mutex_destroy(&bufferManager->pageTable[i].latch);
+		free(bufferManager->pageTable[i].table.slots);
 	}
-	AssignBufferManagerValues(bufferManager, frame);
 }
 
 /*
-1. This method is used to empty the buffer pool and buffer manager
-2. Null value is set to all the properties in buffer pool and manager
+1. This method returns the open page file a page key belongs to
 */
-void CleanBufferPool(BufferManager *bufferManager, BM_BufferPool *bufferPool)
+SM_FileHandle *keyFile(BufferManager *bufferManager, const PageNumber key)
 {
-	int NumberofPages;
-	bufferPool->pageFile = NULL;
-	bufferPool->mgmtData = NULL;
-	bufferPool->numPages = NumberofPages;
-	bufferManager->start = NULL;
-	bufferManager->head = NULL;
-	bufferManager->tail = NULL;
-	free(bufferManager);
+	return bufferManager->files[KEY_FILE_ID(key)];
 }
 
 /*
-1. This method is used to check if the given management data is valid
-2. If Null,returns false. If not null, returns true
+1. This method returns the key of the page a page handle refers to, NO_PAGE if the handle's file id is out of range
 */
-bool CheckValidManagementData(BM_BufferPool *const bufferPool)
+PageNumber handleKey(BM_PageHandle *const page)
 {
-	return (bufferPool->mgmtData == NULL) ? false : true;
+	if (page->fileId < 0 || page->fileId >= BM_MAX_PAGE_FILES)
+		return NO_PAGE;
+	return PAGE_KEY(page->fileId, page->pageNum);
 }
 
 /*
-1. This method is used to assign head from buffer manager to the frame
-2. Takes bufferManager as input and returns the Buffer Frame
+1. This method points a page handle at the page with the given key, whose data is in data
 */
-BufferFrame *getunpinPageFrame(BufferManager *const bufferManager)
+void setPageHandle(BM_PageHandle *const page, const PageNumber key, char *data)
 {
-	BufferFrame *frame = bufferManager->head;
-	return frame;
+	page->fileId = KEY_FILE_ID(key);
+	page->pageNum = KEY_PAGE_NUMBER(key);
+	page->data = data;
 }
 
 /*
-1. This method is used to assign management data from buffer pool
-to the buffer manager
-2. Takes buffer pool as input and returns the Buffer Manager
+1. This method returns the frame holding pageNum, for callers that have the page pinned
+2. Returns NULL if the page is not in the pool
 */
-BufferManager *getunpinPageManager(BM_BufferPool *const bm)
+BufferFrame *findPinnedFrame(BufferManager *bufferManager, const PageNumber pageNum)
 {
-	BufferManager *bufferManager = bm->mgmtData;
-	return bufferManager;
+	PageTablePartition *partition = pageTablePartition(bufferManager, pageNum);
+	BufferFrame *frame;
+	pthread_mutex_lock(&partition->latch);
+	frame = pageTableFind(&partition->table, pageNum);
+	// a frame still writing the page back holds another one by now
+	if (frame != NULL && frame->pageNumber != pageNum)
+		frame = NULL;
+	pthread_mutex_unlock(&partition->latch);
+	return frame;
 }
 
 /*
-1. This method does meory allocation for Buffer Manager and File Handle
-2. Returns Buffer Manager as the output
+1. This method claims an unpinned frame for a new page, the caller holds the pool latch
+2. The frame is latched exclusively and pinned once for the caller; previousPage keeps the page it held
+3. A clean page leaves the page table right away; a dirty one stays listed until its write-back is done,
+so no thread reads the old copy from disk meanwhile
+4. Returns false, leaving the frame alone, if it is pinned or latched
 */
-BufferManager *GetBufferManager()
+bool claimFrame(BufferManager *bufferManager, BufferFrame *frame)
 {
-	BufferManager *bufferManager = (BufferManager *)malloc(sizeof(BufferManager));
-	bufferManager->smFileHandle = (SM_FileHandle *)malloc(sizeof(SM_FileHandle));
-	return bufferManager;
+	PageTablePartition *partition = NULL;
+	PageNumber pageNumber;
+	if (frame->count != 0 || pthread_rwlock_trywrlock(&frame->latch) != 0)
+		return false;
+	pageNumber = frame->pageNumber;
+	if (pageNumber != NO_PAGE)
+	{
+		partition = pageTablePartition(bufferManager, pageNumber);
+		pthread_mutex_lock(&partition->latch);
+	}
+	// a hit may have pinned it since the strategy looked
+	if (frame->count != 0)
+	{
+		if (partition != NULL)
+			pthread_mutex_unlock(&partition->latch);
+		pthread_rwlock_unlock(&frame->latch);
+		return false;
+	}
+	frame->count = 1;
+	frame->loading = 1;
+	frame->previousPage = pageNumber;
+	frame->pageNumber = NO_PAGE;
+	frame->prefetched = 0;
+	frame->inRing = 0;
+	if (partition != NULL)
+	{
+		if (frame->dirtyFlag == 0)
+			pageTableRemove(&partition->table, pageNumber, frame);
+		pthread_mutex_unlock(&partition->latch);
+	}
+	else
+		bufferManager->count++;
+	return true;
 }
 
-BufferManager *createBufferManagerObject()
+/*
+1. This method lists a claimed frame in the page table under the page it is about to load
+2. Threads pinning the page meanwhile wait on the frame's latch until the read is done
+3. Returns false if the page table could not take the entry
+*/
+bool installPage(BufferManager *bufferManager, BufferFrame *frame, const PageNumber pageNumber)
 {
-	BufferManager *bufferManager = (BufferManager *)malloc(sizeof(BufferManager));
-	return bufferManager;
+	PageTablePartition *partition = pageTablePartition(bufferManager, pageNumber);
+	bool inserted;
+	pthread_mutex_lock(&partition->latch);
+	frame->pageNumber = pageNumber;
+	inserted = pageTableInsert(&partition->table, pageNumber, frame);
+	pthread_mutex_unlock(&partition->latch);
+	return inserted;
 }
 
-ReplacementStrategy AssignStrategy(ReplacementStrategy strategy)
+/*
+1. This method looks pageNum up in its page table partition and pins the frame holding it
+2. Returns NULL if the page is not in the pool; transit is set instead if the page is still listed under a frame that was
+claimed for another page and is writing it back, the caller waits for that frame and looks again
+*/
+BufferFrame *CheckIfPageExists(BufferManager *bufferManager, const PageNumber pageNum, BufferFrame **transit)
 {
-	return strategy;
+	PageTablePartition *partition = pageTablePartition(bufferManager, pageNum);
+	BufferFrame *frame;
+	*transit = NULL;
+	pthread_mutex_lock(&partition->latch);
+	frame = pageTableFind(&partition->table, pageNum);
+	if (frame != NULL && frame->pageNumber != pageNum)
+	{
+		*transit = frame;
+		frame = NULL;
+	}
+	else if (frame != NULL)
+		frame->count++;
+	pthread_mutex_unlock(&partition->latch);
+	return frame;
 }
 
-BufferManager *AssignBufferManager(BufferManager *bm)
+/*
+1. This method waits until the thread holding frame exclusively, to load it or to write a page back from it, is done
+*/
+void waitForFrame(BufferFrame *frame)
 {
-	return bm;
+	pthread_rwlock_rdlock(&frame->latch);
+	pthread_rwlock_unlock(&frame->latch);
 }
+
 /*
-Jason Scott - A20436737
-1. This method initiazatizes buffer pool
-2. Opens a existing page with new frames
-3. Initial data is stored within page and closed
+1. This method sets the dirty flag of frame and counts it among the pool's dirty frames
+2. Wakes the background flusher once more than dirtyHighRatio percent of the frames are dirty
 */
-RC initBufferPool(BM_BufferPool *const bm, const char *const pageFileName, const int numPages, ReplacementStrategy strategy, void *stratData)
+void markFrameDirty(BufferManager *bufferManager, BufferFrame *frame)
 {
-	int i;
-	int zero = 0;
-	int pageCount = numPages;
+	if (__atomic_exchange_n(&frame->dirtyFlag, 1, __ATOMIC_SEQ_CST) != 0)
+		return;
+	if (++bufferManager->numDirty > bufferManager->dirtyHighFrames && bufferManager->flusherRunning &&
+		!bufferManager->flushRequested)
+	{
+		pthread_mutex_lock(&bufferManager->flushLatch);
+		bufferManager->flushRequested = 1;
+		pthread_cond_signal(&bufferManager->flushCond);
+		pthread_mutex_unlock(&bufferManager->flushLatch);
+	}
+}
 
-	BufferManager *bufferManager = createBufferManagerObject();
-	bufferManager->start = NULL;
-	SM_FileHandle fHandle;
-	openPageFile((char *)pageFileName, &fHandle);
-	for (i = 0; i < pageCount; i++)
-		createBufferFrame(bufferManager);
-	bufferManager->strategyData = stratData;
-	bufferManager->tail = bufferManager->head;
-	bufferManager->count = zero;
-	bufferManager->numRead = zero;
-	bufferManager->numWrite = zero;
-	bm->numPages = pageCount;
-	bm->pageFile = (char *)pageFileName;
-	bm->strategy = AssignStrategy(strategy);
-	bm->mgmtData = AssignBufferManager(bufferManager);
-	closePageFile(&fHandle);
-	return RC_OK;
+/*
+1. This method clears the dirty flag of frame
+2. Returns true if it was set
+*/
+bool clearFrameDirty(BufferManager *bufferManager, BufferFrame *frame)
+{
+	if (__atomic_exchange_n(&frame->dirtyFlag, 0, __ATOMIC_SEQ_CST) == 0)
+		return false;
+	bufferManager->numDirty--;
+	return true;
 }
 
 /*
-Jason Scott - A20436737
-1. This method opens and checks for dirty pages
-2. All dirtypages with fix count zero are written to disk
-3. Writes it then closes before returning to method above to be destroyed
+1. This method allocates the frequency buckets of an LFU pool and reads its options from stratData
+2. A pool of numPages frames never needs more than numPages + 1 buckets, they are kept on a free list
+3. Returns false if the buckets could not be allocated
 */
-RC forceFlushPool(BM_BufferPool *const bm)
+bool createLFUBuckets(BufferManager *bufferManager, int numPages, BM_LFUData *lfuData)
 {
-	BufferManager *bufferManager = getunpinPageManager(bm);
-	BufferFrame *frame = getunpinPageFrame(bufferManager);
+	int i;
+	bufferManager->lfuLowest = NULL;
+	bufferManager->lfuFreeBuckets = NULL;
+	bufferManager->lfuAgingInterval = (lfuData != NULL) ? lfuData->agingInterval : 0;
+	bufferManager->lfuPins = 0;
+	bufferManager->lfuBuckets = (LFUBucket *)malloc(sizeof(LFUBucket) * (numPages + 1));
+	if (bufferManager->lfuBuckets == NULL)
+		return false;
+	for (i = 0; i <= numPages; i++)
+	{
+		bufferManager->lfuBuckets[i].nextBucket = bufferManager->lfuFreeBuckets;
+		bufferManager->lfuFreeBuckets = &bufferManager->lfuBuckets[i];
+	}
+	return true;
+}
 
-	bufferManager->smFileHandle = (SM_FileHandle *)malloc(sizeof(SM_FileHandle));
-	RC openpageReturnCode = openPageFile((char *)(bm->pageFile), bufferManager->smFileHandle);
-	// again, checking that pages exists since we are not creating one
-	if (openpageReturnCode == RC_OK)
+/*
+1. This method takes a bucket from the free list and links it into the bucket list after the given one
+2. A NULL after makes it the lowest frequency bucket
+*/
+LFUBucket *lfuNewBucket(BufferManager *bufferManager, int frequency, LFUBucket *after)
+{
+	LFUBucket *bucket = bufferManager->lfuFreeBuckets;
+	bufferManager->lfuFreeBuckets = bucket->nextBucket;
+	bucket->frequency = frequency;
+	bucket->first = NULL;
+	bucket->last = NULL;
+	bucket->prevBucket = after;
+	if (after == NULL)
 	{
-		do
-		{ // required case that all pages with fix count 0... then we check if they're dirty
-			if (frame->count == 0)
-			{
-				// from checking, case that dirty pages exist
-				if (frame->dirtyFlag != 0)
-				{
-					int pn = frame->pageNumber;
-					SM_FileHandle *smhandle = bufferManager->smFileHandle;
-					// case in which dirty page is written back to disk
-					RC writeBlockReturnCode = writeBlock(pn, smhandle, frame->data);
-					if (writeBlockReturnCode == RC_OK)
-					{
-						frame->dirtyFlag = 0;
-						bufferManager->numWrite++;
-					}
-					// case we can't write back, we close the page and don't delete
-					else
-					{
-						closePageFile(bufferManager->smFileHandle);
-						return writeBlockReturnCode;
-					}
-				}
-			}
-			// iterate through the frame
-			frame = frame->nextFrame;
-		} while (frame != bufferManager->head);
+		bucket->nextBucket = bufferManager->lfuLowest;
+		bufferManager->lfuLowest = bucket;
 	}
 	else
-		return openpageReturnCode;
-	// close when completed
-	closePageFile(bufferManager->smFileHandle);
-	return RC_OK;
+	{
+		bucket->nextBucket = after->nextBucket;
+		after->nextBucket = bucket;
+	}
+	if (bucket->nextBucket != NULL)
+		bucket->nextBucket->prevBucket = bucket;
+	return bucket;
 }
 
 /*
-Jason Scott - A20436737
-1. This method destroyes buffer pool
-2. Utilizes forceflush method to write all the dirtyPages back again, before destroying
-3. It frees up the buffer pool's resources
+1. This method unlinks a bucket from the bucket list and returns it to the free list
 */
-RC shutdownBufferPool(BM_BufferPool *const bm)
+void lfuFreeBucket(BufferManager *bufferManager, LFUBucket *bucket)
 {
-	int i;
-	// checks it exists/init and is good to go
-	if (!CheckValidManagementData(bm))
-		return RC_BUFFER_POOL_NOT_INIT;
-	// load the mgmt of buffer pool and gets head node
-	BufferManager *bufferManager = bm->mgmtData;
+	if (bucket->prevBucket != NULL)
+		bucket->prevBucket->nextBucket = bucket->nextBucket;
+	else
+		bufferManager->lfuLowest = bucket->nextBucket;
+	if (bucket->nextBucket != NULL)
+		bucket->nextBucket->prevBucket = bucket->prevBucket;
+	bucket->nextBucket = bufferManager->lfuFreeBuckets;
+	bufferManager->lfuFreeBuckets = bucket;
+}
+
+/*
+1. This method makes frame the most recently used frame of bucket
+*/
+void lfuPushFrame(LFUBucket *bucket, BufferFrame *frame)
+{
+	frame->bucket = bucket;
+	frame->bucketPrev = NULL;
+	frame->bucketNext = bucket->first;
+	if (bucket->first != NULL)
+		bucket->first->bucketPrev = frame;
+	else
+		bucket->last = frame;
+	bucket->first = frame;
+}
+
+/*
+1. This method removes frame from its bucket
+2. A bucket left empty goes back to the free list
+*/
+void lfuUnlinkFrame(BufferManager *bufferManager, BufferFrame *frame)
+{
+	LFUBucket *bucket = frame->bucket;
+	if (frame->bucketPrev != NULL)
+		frame->bucketPrev->bucketNext = frame->bucketNext;
+	else
+		bucket->first = frame->bucketNext;
+	if (frame->bucketNext != NULL)
+		frame->bucketNext->bucketPrev = frame->bucketPrev;
+	else
+		bucket->last = frame->bucketPrev;
+	frame->bucket = NULL;
+	if (bucket->first == NULL)
+		lfuFreeBucket(bufferManager, bucket);
+}
+
+/*
+1. This method files an empty frame that is in no bucket under frequency 0
+*/
+void lfuAddEmptyFrame(BufferManager *bufferManager, BufferFrame *frame)
+{
+	if (bufferManager->lfuLowest != NULL && bufferManager->lfuLowest->frequency == 0)
+		lfuPushFrame(bufferManager->lfuLowest, frame);
+	else
+		lfuPushFrame(lfuNewBucket(bufferManager, 0, NULL), frame);
+}
+
+/*
+1. This method puts every frame of a new LFU pool into a bucket of frequency 0
+2. Empty frames are therefore always used before any page is replaced
+*/
+void lfuAddEmptyFrames(BufferManager *bufferManager)
+{
+	LFUBucket *bucket = lfuNewBucket(bufferManager, 0, NULL);
 	BufferFrame *frame = bufferManager->head;
-	// calls upon forceflush method for dirty pages with fix count 0 to be written
-	forceFlushPool(bm);
-	// iterates through frames
-	frame = frame->nextFrame;
-	// frees all the page data in the frame
-	for (i = 0; frame != bufferManager->head; i++)
+	do
+	{
+		lfuPushFrame(bucket, frame);
+		frame = frame->nextFrame;
+	} while (frame != bufferManager->head);
+}
+
+/*
+1. This method counts a hit on frame, it moves to the bucket of the next frequency
+2. Constant time: the next bucket is either the neighbour in the list or a new one inserted after the current bucket
+*/
+void lfuTouch(BufferManager *bufferManager, BufferFrame *frame)
+{
+	LFUBucket *bucket = frame->bucket;
+	LFUBucket *target = bucket->nextBucket;
+	// the count saturates, the page is as hot as it gets
+	if (bucket->frequency == INT_MAX)
+		return;
+	if (target == NULL || target->frequency != bucket->frequency + 1)
+		target = lfuNewBucket(bufferManager, bucket->frequency + 1, bucket);
+	lfuUnlinkFrame(bufferManager, frame);
+	lfuPushFrame(target, frame);
+}
+
+/*
+1. This method files a frame that was just loaded with a new page under frequency 1
+2. The frame must have been unlinked from its old bucket
+*/
+void lfuInsertLoaded(BufferManager *bufferManager, BufferFrame *frame)
+{
+	// empty frames of frequency 0 stay in front
+	LFUBucket *after = (bufferManager->lfuLowest != NULL && bufferManager->lfuLowest->frequency == 0) ? bufferManager->lfuLowest : NULL;
+	LFUBucket *target = (after != NULL) ? after->nextBucket : bufferManager->lfuLowest;
+	if (target == NULL || target->frequency != 1)
+		target = lfuNewBucket(bufferManager, 1, after);
+	lfuPushFrame(target, frame);
+}
+
+/*
+1. This method ages the LFU pool, the use count of every page is halved (but stays at least 1)
+2. Buckets that end up with the same frequency are merged, frames of the colder bucket are replaced first
+*/
+void lfuAge(BufferManager *bufferManager)
+{
+	LFUBucket *bucket = bufferManager->lfuLowest;
+	bufferManager->lfuAgings++;
+	while (bucket != NULL)
+	{
+		LFUBucket *next = bucket->nextBucket;
+		LFUBucket *prev = bucket->prevBucket;
+		if (bucket->frequency > 1)
+			bucket->frequency /= 2;
+		// halving keeps the order, so only the previous bucket can collide
+		if (prev != NULL && prev->frequency == bucket->frequency)
+		{
+			BufferFrame *frame;
+			for (frame = bucket->first; frame != NULL; frame = frame->bucketNext)
+				frame->bucket = prev;
+			bucket->last->bucketNext = prev->first;
+			prev->first->bucketPrev = bucket->last;
+			prev->first = bucket->first;
+			bucket->first = NULL;
+			lfuFreeBucket(bufferManager, bucket);
+		}
+		bucket = next;
+	}
+}
+
+/*
+1. This method counts a pin of an LFU pool and ages the pool once every lfuAgingInterval pins
+*/
+void lfuCountPin(BufferManager *bufferManager)
+{
+	if (bufferManager->lfuAgingInterval <= 0)
+		return;
+	if (++bufferManager->lfuPins >= bufferManager->lfuAgingInterval)
+	{
+		lfuAge(bufferManager);
+		bufferManager->lfuPins = 0;
+	}
+}
+
+/*
+1. This method allocates the reference history of an LRU-K pool and reads K, the correlated reference period and the retained history size from stratData
+2. Without stratData the pool runs LRU-2 without a correlated reference period and retains the history of numPages evicted pages
+3. Returns false if the history could not be allocated
+*/
+bool createLRUKHistory(BufferManager *bufferManager, int numPages, BM_LRUKData *lrukData)
+{
+	int i;
+	bufferManager->lrukK = (lrukData != NULL && lrukData->k > 0) ? lrukData->k : 2;
+	bufferManager->lrukCorrelatedPeriod = (lrukData != NULL && lrukData->correlatedPeriod > 0) ? lrukData->correlatedPeriod : 0;
+	bufferManager->lrukRetainedSize = (lrukData != NULL) ? lrukData->historySize : numPages;
+	if (bufferManager->lrukRetainedSize < 0)
+		bufferManager->lrukRetainedSize = 0;
+	bufferManager->lrukClock = 0;
+	bufferManager->lrukRetainedNext = 0;
+	bufferManager->lrukFrameHistory = (int64_t *)calloc((size_t)numPages * bufferManager->lrukK, sizeof(int64_t));
+	bufferManager->lrukRetained = (LRUKHistoryEntry *)malloc(sizeof(LRUKHistoryEntry) * (bufferManager->lrukRetainedSize + 1));
+	bufferManager->lrukRetainedHistory = (int64_t *)calloc((size_t)(bufferManager->lrukRetainedSize + 1) * bufferManager->lrukK, sizeof(int64_t));
+	// sized like a page table, a power of two at least twice the entries
+	bufferManager->lrukRetainedBits = 1;
+	while (bufferManager->lrukRetainedBits < 30 && (1 << bufferManager->lrukRetainedBits) < 2 * bufferManager->lrukRetainedSize)
+		bufferManager->lrukRetainedBits++;
+	bufferManager->lrukRetainedSlots = (int *)malloc(sizeof(int) << bufferManager->lrukRetainedBits);
+	if (bufferManager->lrukFrameHistory == NULL || bufferManager->lrukRetained == NULL || bufferManager->lrukRetainedHistory == NULL ||
+		bufferManager->lrukRetainedSlots == NULL)
+		return false;
+	for (i = 0; i < bufferManager->lrukRetainedSize; i++)
+	{
+		bufferManager->lrukRetained[i].pageNumber = NO_PAGE;
+		bufferManager->lrukRetained[i].history = bufferManager->lrukRetainedHistory + (size_t)i * bufferManager->lrukK;
+	}
+	for (i = 0; i < (1 << bufferManager->lrukRetainedBits); i++)
+		bufferManager->lrukRetainedSlots[i] = -1;
+	return true;
+}
+
+/*
+1. This method frees the reference history of an LRU-K pool
+*/
+void freeLRUKHistory(BufferManager *bufferManager)
+{
+	free(bufferManager->lrukFrameHistory);
+	free(bufferManager->lrukRetained);
+	free(bufferManager->lrukRetainedHistory);
+	free(bufferManager->lrukRetainedSlots);
+}
+
+/*
+1. This method gives every frame of a new LRU-K pool its slice of the history array
+*/
+void lrukAttachFrames(BufferManager *bufferManager)
+{
+	BufferFrame *frame = bufferManager->head;
+	int i = 0;
+	do
+	{
+		frame->history = bufferManager->lrukFrameHistory + (size_t)i++ * bufferManager->lrukK;
+		frame = frame->nextFrame;
+	} while (frame != bufferManager->head);
+}
+
+/*
+1. This method records a hit on a page of an LRU-K pool
+2. history[0] is the most recent uncorrelated reference, history[K - 1] the K-th most recent one, 0 if there was none
+3. References within the correlated reference period of the last one only move lastReference;
+otherwise the older references are shifted by the length of the correlated period that just ended
+*/
+void lrukReference(BufferManager *bufferManager, BufferFrame *frame)
+{
+	int64_t now = bufferManager->lrukClock;
+	int i;
+	if (now - frame->lastReference > bufferManager->lrukCorrelatedPeriod)
+	{
+		int64_t correlatedPeriod = frame->lastReference - frame->history[0];
+		for (i = bufferManager->lrukK - 1; i > 0; i--)
+			frame->history[i] = (frame->history[i - 1] != 0) ? frame->history[i - 1] + correlatedPeriod : 0;
+		frame->history[0] = now;
+	}
+	frame->lastReference = now;
+}
+
+/*
+1. This method returns the slot of the retained history index where pageNumber's entry is, or the empty slot ending its probes
+2. Probes like the page table: Fibonacci hash, linear probing
+*/
+int lrukRetainedSlot(BufferManager *bufferManager, const PageNumber pageNumber)
+{
+	int mask = (1 << bufferManager->lrukRetainedBits) - 1;
+	int slot = (int)(((uint64_t)pageNumber * PAGE_TABLE_HASH_MULTIPLIER) >> (64 - bufferManager->lrukRetainedBits));
+	while (bufferManager->lrukRetainedSlots[slot] >= 0 &&
+		   bufferManager->lrukRetained[bufferManager->lrukRetainedSlots[slot]].pageNumber != pageNumber)
+		slot = (slot + 1) & mask;
+	return slot;
+}
+
+/*
+1. This method drops the retained entry of pageNumber, if there is one, from the history and its index
+2. Later entries of the probe cluster are shifted back into the hole, as in pageTableRemove
+*/
+void lrukForgetRetained(BufferManager *bufferManager, const PageNumber pageNumber)
+{
+	int mask = (1 << bufferManager->lrukRetainedBits) - 1;
+	int hole = lrukRetainedSlot(bufferManager, pageNumber);
+	int slot;
+	if (bufferManager->lrukRetainedSlots[hole] < 0)
+		return;
+	bufferManager->lrukRetained[bufferManager->lrukRetainedSlots[hole]].pageNumber = NO_PAGE;
+	bufferManager->lrukRetainedSlots[hole] = -1;
+	for (slot = (hole + 1) & mask; bufferManager->lrukRetainedSlots[slot] >= 0; slot = (slot + 1) & mask)
+	{
+		PageNumber key = bufferManager->lrukRetained[bufferManager->lrukRetainedSlots[slot]].pageNumber;
+		int home = (int)(((uint64_t)key * PAGE_TABLE_HASH_MULTIPLIER) >> (64 - bufferManager->lrukRetainedBits));
+		if (((slot - home) & mask) >= ((slot - hole) & mask))
+		{
+			bufferManager->lrukRetainedSlots[hole] = bufferManager->lrukRetainedSlots[slot];
+			bufferManager->lrukRetainedSlots[slot] = -1;
+			hole = slot;
+		}
+	}
+}
+
+/*
+1. This method keeps the reference times of the page a claimed frame held in the retained history
+2. The history is a ring, the oldest entry is overwritten when it is full; an older entry of the same page is dropped
+*/
+void lrukRetain(BufferManager *bufferManager, BufferFrame *frame)
+{
+	LRUKHistoryEntry *entry;
+	int next;
+	if (bufferManager->lrukRetainedSize == 0 || frame->previousPage == NO_PAGE)
+		return;
+	next = bufferManager->lrukRetainedNext;
+	entry = &bufferManager->lrukRetained[next];
+	bufferManager->lrukRetainedNext = (bufferManager->lrukRetainedNext + 1) % bufferManager->lrukRetainedSize;
+	if (entry->pageNumber != NO_PAGE)
+		lrukForgetRetained(bufferManager, entry->pageNumber);
+	lrukForgetRetained(bufferManager, frame->previousPage);
+	bufferManager->lrukRetainedSlots[lrukRetainedSlot(bufferManager, frame->previousPage)] = next;
+	entry->pageNumber = frame->previousPage;
+	entry->lastReference = frame->lastReference;
+	memcpy(entry->history, frame->history, sizeof(int64_t) * bufferManager->lrukK);
+}
+
+/*
+1. This method sets up the history of pageNumber, which is being loaded into frame
+2. Reference times retained from an earlier stay in the pool are restored and the entry is dropped, a new page starts with just this reference
+3. The entry is found through the retained history index, so a miss costs no scan of the history
+*/
+void lrukLoad(BufferManager *bufferManager, BufferFrame *frame, const PageNumber pageNumber)
+{
+	int64_t now = bufferManager->lrukClock;
+	int i;
+	memset(frame->history, 0, sizeof(int64_t) * bufferManager->lrukK);
+	if (pageNumber != NO_PAGE && bufferManager->lrukRetainedSize > 0)
+	{
+		int entry = bufferManager->lrukRetainedSlots[lrukRetainedSlot(bufferManager, pageNumber)];
+		if (entry >= 0)
+		{
+			memcpy(frame->history, bufferManager->lrukRetained[entry].history, sizeof(int64_t) * bufferManager->lrukK);
+			lrukForgetRetained(bufferManager, pageNumber);
+			bufferManager->lrukRetainedHits++;
+		}
+	}
+	for (i = bufferManager->lrukK - 1; i > 0; i--)
+		frame->history[i] = frame->history[i - 1];
+	frame->history[0] = now;
+	frame->lastReference = now;
+}
+
+/*
+1. This method picks and claims the victim frame of an LRU-K pool
+2. Among unpinned frames outside their correlated reference period the one with the largest backward K-distance wins, i.e. the oldest K-th reference;
+frames with fewer than K references have an infinite distance and go first, ties go to the least recently used frame
+3. If every unpinned frame is inside its correlated period, the least recently used one is taken; returns NULL if every frame is pinned
+4. Should the chosen frame be pinned or latched by another thread before it is claimed, the first frame that can be claimed is taken
+*/
+BufferFrame *lrukVictim(BufferManager *bufferManager)
+{
+	int64_t now = bufferManager->lrukClock;
+	int k = bufferManager->lrukK;
+	BufferFrame *victim = NULL;
+	BufferFrame *fallback = NULL;
+	BufferFrame *frame = bufferManager->head;
+	do
+	{
+		if (frame->count == 0)
+		{
+			// empty frames first
+			if (frame->pageNumber == NO_PAGE && claimFrame(bufferManager, frame))
+				return frame;
+			if (fallback == NULL || frame->lastReference < fallback->lastReference)
+				fallback = frame;
+			if (now - frame->lastReference > bufferManager->lrukCorrelatedPeriod &&
+				(victim == NULL || frame->history[k - 1] < victim->history[k - 1] ||
+				 (frame->history[k - 1] == victim->history[k - 1] && frame->history[0] < victim->history[0])))
+				victim = frame;
+		}
+		frame = frame->nextFrame;
+	} while (frame != bufferManager->head);
+	if (victim == NULL)
+		victim = fallback;
+	if (victim != NULL && claimFrame(bufferManager, victim))
+		return victim;
+	do
+	{
+		if (claimFrame(bufferManager, frame))
+			return frame;
+		frame = frame->nextFrame;
+	} while (frame != bufferManager->head);
+	return NULL;
+}
+
+/*
+1. This method makes frame the most recently used entry of an ARC list
+*/
+void arcPush(ARCList *list, BufferFrame *frame)
+{
+	frame->arcList = list;
+	frame->arcPrev = NULL;
+	frame->arcNext = list->first;
+	if (list->first != NULL)
+		list->first->arcPrev = frame;
+	else
+		list->last = frame;
+	list->first = frame;
+	list->size++;
+}
+
+/*
+1. This method removes frame from its ARC list
+*/
+void arcRemove(BufferFrame *frame)
+{
+	ARCList *list = frame->arcList;
+	if (frame->arcPrev != NULL)
+		frame->arcPrev->arcNext = frame->arcNext;
+	else
+		list->first = frame->arcNext;
+	if (frame->arcNext != NULL)
+		frame->arcNext->arcPrev = frame->arcPrev;
+	else
+		list->last = frame->arcPrev;
+	list->size--;
+	frame->arcList = NULL;
+}
+
+/*
+1. This method allocates the ghost entries of an ARC pool
+2. Ghosts are frames without data; B1 and B2 together never hold more than numPages of them
+3. Returns false if the ghosts could not be allocated
+*/
+bool createARCGhosts(BufferManager *bufferManager, int numPages)
+{
+	int i;
+	memset(&bufferManager->arcT1, 0, sizeof(ARCList));
+	memset(&bufferManager->arcT2, 0, sizeof(ARCList));
+	memset(&bufferManager->arcB1, 0, sizeof(ARCList));
+	memset(&bufferManager->arcB2, 0, sizeof(ARCList));
+	memset(&bufferManager->arcFree, 0, sizeof(ARCList));
+	bufferManager->arcTarget = 0;
+	bufferManager->arcFreeGhosts = NULL;
+	bufferManager->arcGhostTable.slots = NULL;
+	bufferManager->arcGhosts = (BufferFrame *)calloc(numPages + 1, sizeof(BufferFrame));
+	if (bufferManager->arcGhosts == NULL || !createPageTable(&bufferManager->arcGhostTable, numPages + 1))
+		return false;
+	for (i = 0; i <= numPages; i++)
+	{
+		bufferManager->arcGhosts[i].arcNext = bufferManager->arcFreeGhosts;
+		bufferManager->arcFreeGhosts = &bufferManager->arcGhosts[i];
+	}
+	return true;
+}
+
+/*
+1. This method frees the ghost entries of an ARC pool
+*/
+void freeARCGhosts(BufferManager *bufferManager)
+{
+	free(bufferManager->arcGhosts);
+	free(bufferManager->arcGhostTable.slots);
+}
+
+/*
+1. This method puts every frame of a new ARC pool on the list of free frames
+*/
+void arcAddEmptyFrames(BufferManager *bufferManager)
+{
+	BufferFrame *frame = bufferManager->head;
+	do
+	{
+		arcPush(&bufferManager->arcFree, frame);
+		frame = frame->nextFrame;
+	} while (frame != bufferManager->head);
+}
+
+/*
+1. This method forgets a ghost, it leaves its list and the ghost table
+*/
+void arcForgetGhost(BufferManager *bufferManager, BufferFrame *ghost)
+{
+	arcRemove(ghost);
+	pageTableRemove(&bufferManager->arcGhostTable, ghost->pageNumber, ghost);
+	ghost->arcNext = bufferManager->arcFreeGhosts;
+	bufferManager->arcFreeGhosts = ghost;
+}
+
+/*
+1. This method remembers a page replaced from T1 or T2 as the most recent ghost of B1 or B2
+*/
+void arcAddGhost(BufferManager *bufferManager, ARCList *ghostList, PageNumber pageNumber)
+{
+	BufferFrame *ghost;
+	// pinned frames can make ARC replace from the other list, keep the ghosts within their bound anyway
+	if (bufferManager->arcFreeGhosts == NULL)
+		arcForgetGhost(bufferManager, (bufferManager->arcB1.size >= bufferManager->arcB2.size) ? bufferManager->arcB1.last : bufferManager->arcB2.last);
+	ghost = bufferManager->arcFreeGhosts;
+	bufferManager->arcFreeGhosts = ghost->arcNext;
+	ghost->pageNumber = pageNumber;
+	pageTableInsert(&bufferManager->arcGhostTable, pageNumber, ghost);
+	arcPush(ghostList, ghost);
+}
+
+/*
+1. This method claims the least recently used frame of an ARC list that is neither pinned nor latched, NULL if there is none
+*/
+BufferFrame *arcClaimLRU(BufferManager *bufferManager, ARCList *list)
+{
+	BufferFrame *frame;
+	for (frame = list->last; frame != NULL; frame = frame->arcPrev)
+		if (claimFrame(bufferManager, frame))
+			return frame;
+	return NULL;
+}
+
+/*
+1. This method is ARC's REPLACE: it claims the frame to reuse from T1 if T1 is above its target (or at it, when the missed page is a B2 ghost), otherwise from T2
+2. If every frame of that list is pinned the other list is used; ghostList returns where the replaced page is remembered
+3. Returns NULL if every frame is pinned
+*/
+BufferFrame *arcReplace(BufferManager *bufferManager, bool inB2, ARCList **ghostList)
+{
+	BufferFrame *frame = NULL;
+	int sizeT1 = bufferManager->arcT1.size;
+	if (sizeT1 >= 1 && ((inB2 && sizeT1 == bufferManager->arcTarget) || sizeT1 > bufferManager->arcTarget))
+	{
+		frame = arcClaimLRU(bufferManager, &bufferManager->arcT1);
+		*ghostList = &bufferManager->arcB1;
+	}
+	if (frame == NULL)
+	{
+		frame = arcClaimLRU(bufferManager, &bufferManager->arcT2);
+		*ghostList = &bufferManager->arcB2;
+	}
+	if (frame == NULL)
+	{
+		frame = arcClaimLRU(bufferManager, &bufferManager->arcT1);
+		*ghostList = &bufferManager->arcB1;
+	}
+	return frame;
+}
+
+/*1. This method is used to assign frame values such as previous frame, next frame, tail, head
+2. Takes BufferManger and BufferFrame as the input
+3. Assigns values to the frame and buffer manager
+*/
+void AssignBufferManagerValues(BufferManager *bufferManager, BufferFrame *frame)
+{ // define head as start of buffer
+	bufferManager->head = bufferManager->start;
+	// case that head has a value
+	if (bufferManager->head != NULL)
+	{ // case frame has a value
+		if (frame != NULL)
+		{
+			// assigns values to frame and manager
+			bufferManager->tail->nextFrame = frame;
+			frame->prevFrame = bufferManager->tail;
+			bufferManager->tail = bufferManager->tail->nextFrame;
+		}
+	}
+	// case head has no value
+	else
+	{
+		if (frame != NULL)
+		{
+			bufferManager->head = frame;
+			bufferManager->tail = bufferManager->head;
+			bufferManager->start = bufferManager->tail;
+		}
+	}
+	// iterate through
+	bufferManager->tail->nextFrame = bufferManager->head;
+	bufferManager->head->prevFrame = bufferManager->tail;
+}
+
+/*
+1. This method frees a frame segment: its arena, its descriptors and what it added to the strategy
+*/
+void freeFrameSegment(FrameSegment *segment)
+{
+	if (segment->arena != NULL)
+		munmap(segment->arena, segment->arenaSize);
+	free(segment->frames);
+	free(segment->lfuBuckets);
+	free(segment->arcGhosts);
+	free(segment->lrukHistory);
+	free(segment);
+}
+
+/*
+1. This method allocates a frame segment of numPages frames: one page-aligned mapping (the arena) holding their data,
+and a dense array of their descriptors
+2. With the pool's hugePages option the mapping is rounded up to whole huge pages and taken from MAP_HUGETLB; if none are
+reserved it falls back to ordinary pages with transparent huge pages requested through madvise
+3. Anonymous mappings start zeroed, every frame starts as an empty page
+4. Returns NULL if the segment could not be allocated; the caller links it into the pool's segments
+*/
+FrameSegment *createFrameSegment(BufferManager *bufferManager, int numPages)
+{
+	FrameSegment *segment = (FrameSegment *)calloc(1, sizeof(FrameSegment));
+	size_t size = (size_t)numPages * bufferManager->pageSize;
+	char *arena = MAP_FAILED;
+	if (segment == NULL)
+		return NULL;
+	if (bufferManager->hugePages)
+	{
+		size = (size + BM_HUGE_PAGE_SIZE - 1) & ~(BM_HUGE_PAGE_SIZE - 1);
+		arena = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+	}
+	if (arena == MAP_FAILED)
+	{
+		arena = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (arena != MAP_FAILED && bufferManager->hugePages)
+			madvise(arena, size, MADV_HUGEPAGE);
+	}
+	segment->arena = (arena == MAP_FAILED) ? NULL : arena;
+	segment->arenaSize = size;
+	segment->numFrames = numPages;
+	segment->frames = (BufferFrame *)calloc(numPages, sizeof(BufferFrame));
+	if (segment->arena == NULL || segment->frames == NULL)
+	{
+		freeFrameSegment(segment);
+		return NULL;
+	}
+	return segment;
+}
+
+/*
+1. This method frees the frame segments of a pool and its frame table
+*/
+void freeFrameSegments(BufferManager *bufferManager)
+{
+	while (bufferManager->segments != NULL)
+	{
+		FrameSegment *segment = bufferManager->segments;
+		bufferManager->segments = segment->next;
+		freeFrameSegment(segment);
+	}
+	free(bufferManager->frames);
+	bufferManager->frames = NULL;
+}
+
+/*
+Different approach: External method to be used within initbufferpool
+1. This method creates the buffer frame from the buffer manager
+2. dirty flag, count, pagenumber and frames will be initialized
+3. The descriptor is a slot of a frame segment and data one page of its arena, aligned to the page size so
+SM_IO_DIRECT pools need no bounce copy
+*/
+void createBufferFrame(BufferManager *bufferManager, BufferFrame *frame, char *data)
+{
+	int i = 0;
+	int pn = -1;
+	frame->data = data;
+	// counts num of dirty flags
+	if (i == 0)
+	{
+		frame->dirtyFlag = i;
+		frame->count = i;
+		frame->refBit = i;
+	}
+	frame->bucket = NULL;
+	frame->bucketPrev = NULL;
+	frame->bucketNext = NULL;
+	frame->history = NULL;
+	frame->lastReference = 0;
+	frame->arcList = NULL;
+	frame->arcPrev = NULL;
+	frame->arcNext = NULL;
+	pthread_rwlock_init(&frame->latch, NULL);
+	frame->loading = 0;
+	frame->previousPage = NO_PAGE;
+	frame->ioResult = RC_OK;
+	frame->prefetched = 0;
+	if (pn == -1)
+	{
+		frame->pageNumber = pn;
+	}
+	AssignBufferManagerValues(bufferManager, frame);
+}
+
+/*
+1. This method is used to empty the buffer pool and buffer manager
+2. Null value is set to all the properties in buffer pool and manager
+*/
+void CleanBufferPool(BufferManager *bufferManager, BM_BufferPool *bufferPool)
+{
+	int NumberofPages;
+	bufferPool->pageFile = NULL;
+	bufferPool->mgmtData = NULL;
+	bufferPool->numPages = NumberofPages;
+	bufferManager->start = NULL;
+	bufferManager->head = NULL;
+	bufferManager->tail = NULL;
+	free(bufferManager);
+}
+
+/*
+1. This method is used to check if the given management data is valid
+2. If Null,returns false. If not null, returns true
+*/
+bool CheckValidManagementData(BM_BufferPool *const bufferPool)
+{
+	return (bufferPool->mgmtData == NULL) ? false : true;
+}
+
+/*
+1. This method is used to assign head from buffer manager to the frame
+2. Takes bufferManager as input and returns the Buffer Frame
+*/
+BufferFrame *getunpinPageFrame(BufferManager *const bufferManager)
+{
+	BufferFrame *frame = bufferManager->head;
+	return frame;
+}
+
+/*
+1. This method is used to assign management data from buffer pool
+to the buffer manager
+2. Takes buffer pool as input and returns the Buffer Manager
+*/
+BufferManager *getunpinPageManager(BM_BufferPool *const bm)
+{
+	BufferManager *bufferManager = bm->mgmtData;
+	return bufferManager;
+}
+
+/*
+1. This method does meory allocation for Buffer Manager and File Handle
+2. The Buffer Manager starts zeroed, so a failed initBufferPool only frees what it had set up
+3. Returns Buffer Manager as the output
+*/
+BufferManager *GetBufferManager()
+{
+	BufferManager *bufferManager = (BufferManager *)calloc(1, sizeof(BufferManager));
+	bufferManager->files[0] = (SM_FileHandle *)malloc(sizeof(SM_FileHandle));
+	return bufferManager;
+}
+
+ReplacementStrategy AssignStrategy(ReplacementStrategy strategy)
+{
+	return strategy;
+}
+
+BufferManager *AssignBufferManager(BufferManager *bm)
+{
+	return bm;
+}
+/*
+1. qsort comparator ordering page table entries by their page number
+*/
+int compareEntryPageNumber(const void *a, const void *b)
+{
+	const PageTableEntry *left = (const PageTableEntry *)a;
+	const PageTableEntry *right = (const PageTableEntry *)b;
+	return (left->pageNumber > right->pageNumber) - (left->pageNumber < right->pageNumber);
+}
+
+/*
+1. This method writes up to limit dirty pages with fix count zero to disk, lowest page numbers first
+2. Each frame is latched exclusive, without waiting, and checked again before it is written, other threads may have pinned
+or reused it meanwhile; the write stamps the checksum trailer into the frame, so no other flush or forcePage may share it;
+its dirty flag is cleared before the write, so a page dirtied again during it stays dirty
+3. Each run of adjacent pages of a file goes out with a single writeBlocks call
+4. Only pages of the file fileId are written unless it is -1
+5. Used by forceFlushPool, detachPageFile and by the background flusher
+*/
+RC flushDirtyFrames(BufferManager *bufferManager, int limit, const int fileId)
+{
+	BufferFrame *frame;
+	PageTableEntry *dirtyFrames;
+	SM_PageHandle *pages;
+	int numDirty = 0;
+	int numLatched = 0;
+	int i, j, k;
+	RC returnCode = RC_OK;
+
+	pthread_rwlock_rdlock(&bufferManager->framesLatch);
+	dirtyFrames = malloc(sizeof(PageTableEntry) * bufferManager->numFrames);
+	pages = malloc(sizeof(SM_PageHandle) * bufferManager->numFrames);
+	if (dirtyFrames == NULL || pages == NULL)
+	{
+		pthread_rwlock_unlock(&bufferManager->framesLatch);
+		free(dirtyFrames);
+		free(pages);
+		return RC_WRITE_FAILED;
+	}
+	for (i = 0; i < bufferManager->numFrames; i++)
+	{ // required case that all pages with fix count 0... then we check if they're dirty
+		PageNumber pageNumber;
+		frame = bufferManager->frames[i];
+		pageNumber = frame->pageNumber;
+		if (frame->count == 0 && frame->dirtyFlag != 0 && pageNumber != NO_PAGE && (fileId < 0 || KEY_FILE_ID(pageNumber) == fileId))
+		{
+			dirtyFrames[numDirty].pageNumber = pageNumber;
+			dirtyFrames[numDirty++].frame = frame;
+		}
+	}
+
+	qsort(dirtyFrames, numDirty, sizeof(PageTableEntry), compareEntryPageNumber);
+	if (numDirty > limit)
+		numDirty = limit;
+	for (i = 0; i < numDirty; i++)
+	{
+		frame = dirtyFrames[i].frame;
+		// an unpinned frame latched exclusively is being claimed, its new owner writes the page back; any other holder is
+		// writing it out already
+		if (pthread_rwlock_trywrlock(&frame->latch) != 0)
+			continue;
+		if (frame->pageNumber == dirtyFrames[i].pageNumber && frame->count == 0 && frame->dirtyFlag != 0)
+			dirtyFrames[numLatched++] = dirtyFrames[i];
+		else
+			pthread_rwlock_unlock(&frame->latch);
+	}
+	for (i = 0; i < numLatched && returnCode == RC_OK; i = j)
+	{
+		// extend the run while the pages stay adjacent in the same file
+		pages[0] = dirtyFrames[i].frame->data;
+		for (j = i + 1; j < numLatched && dirtyFrames[j].pageNumber == dirtyFrames[j - 1].pageNumber + 1 &&
+						KEY_FILE_ID(dirtyFrames[j].pageNumber) == KEY_FILE_ID(dirtyFrames[i].pageNumber);
+			 j++)
+			pages[j - i] = dirtyFrames[j].frame->data;
+		for (k = i; k < j; k++)
+			clearFrameDirty(bufferManager, dirtyFrames[k].frame);
+		returnCode = writeBlocks(KEY_PAGE_NUMBER(dirtyFrames[i].pageNumber), j - i, keyFile(bufferManager, dirtyFrames[i].pageNumber), pages);
+		// case we can't write back, the run stays dirty
+		if (returnCode != RC_OK)
+			for (k = i; k < j; k++)
+				markFrameDirty(bufferManager, dirtyFrames[k].frame);
+		else
+		{
+			bufferManager->numWrite += j - i;
+			bufferManager->numFlushWrites += j - i;
+		}
+	}
+	for (i = 0; i < numLatched; i++)
+		pthread_rwlock_unlock(&dirtyFrames[i].frame->latch);
+	pthread_rwlock_unlock(&bufferManager->framesLatch);
+	free(dirtyFrames);
+	free(pages);
+	return returnCode;
+}
+
+/*
+1. This method is the background flusher of a pool, started by initBufferPoolWithOptions with backgroundFlush set
+2. Every flushInterval milliseconds, or as soon as more than dirtyHighRatio percent of the frames are dirty, it writes
+dirty unpinned pages until only dirtyLowRatio percent are left, so replacing them later needs no write
+3. It runs until shutdownBufferPool sets flusherStop
+*/
+void *runFlusher(void *arg)
+{
+	BufferManager *bufferManager = (BufferManager *)arg;
+	struct timespec deadline;
+	pthread_mutex_lock(&bufferManager->flushLatch);
+	while (!bufferManager->flusherStop)
+	{
+		clock_gettime(CLOCK_REALTIME, &deadline);
+		deadline.tv_sec += bufferManager->flushInterval / 1000;
+		deadline.tv_nsec += (long)(bufferManager->flushInterval % 1000) * 1000000;
+		if (deadline.tv_nsec >= 1000000000)
+		{
+			deadline.tv_sec++;
+			deadline.tv_nsec -= 1000000000;
+		}
+		// sleep out the interval unless markDirty asks for a round or the pool shuts down
+		while (!bufferManager->flusherStop && !bufferManager->flushRequested &&
+			   pthread_cond_timedwait(&bufferManager->flushCond, &bufferManager->flushLatch, &deadline) != ETIMEDOUT)
+			;
+		if (bufferManager->flusherStop)
+			break;
+		bufferManager->flushRequested = 0;
+		pthread_mutex_unlock(&bufferManager->flushLatch);
+		flushDirtyFrames(bufferManager, bufferManager->numDirty - bufferManager->dirtyLowFrames, -1);
+		pthread_mutex_lock(&bufferManager->flushLatch);
+	}
+	pthread_mutex_unlock(&bufferManager->flushLatch);
+	return NULL;
+}
+
+/*
+1. This method turns the flusher's dirty ratios into frame counts of the pool
+*/
+void setDirtyThresholds(BufferManager *bufferManager)
+{
+	bufferManager->dirtyHighFrames = (int)((int64_t)bufferManager->numFrames * bufferManager->dirtyHighRatio / 100);
+	bufferManager->dirtyLowFrames = (int)((int64_t)bufferManager->numFrames * bufferManager->dirtyLowRatio / 100);
+}
+
+/*
+1. This method starts the background flusher of a pool if options ask for one
+2. The dirty ratios are turned into frame counts of the pool
+3. Returns false if the thread could not be started
+*/
+bool startFlusher(BufferManager *bufferManager, BM_PoolOptions *const options)
+{
+	bufferManager->flusherRunning = false;
+	bufferManager->flusherStop = false;
+	bufferManager->flushRequested = 0;
+	bufferManager->flushInterval = (options->flushInterval > 0) ? options->flushInterval : 1;
+	bufferManager->dirtyHighRatio = options->dirtyHighRatio;
+	bufferManager->dirtyLowRatio = options->dirtyLowRatio;
+	setDirtyThresholds(bufferManager);
+	pthread_mutex_init(&bufferManager->flushLatch, NULL);
+	pthread_cond_init(&bufferManager->flushCond, NULL);
+	if (!options->backgroundFlush)
+		return true;
+	if (pthread_create(&bufferManager->flusher, NULL, runFlusher, bufferManager) != 0)
+		return false;
+	bufferManager->flusherRunning = true;
+	return true;
+}
+
+/*
+1. This method stops the background flusher, waiting for its current round to end, and frees its latches
+*/
+void stopFlusher(BufferManager *bufferManager)
+{
+	if (bufferManager->flusherRunning)
+	{
+		pthread_mutex_lock(&bufferManager->flushLatch);
+		bufferManager->flusherStop = true;
+		pthread_cond_signal(&bufferManager->flushCond);
+		pthread_mutex_unlock(&bufferManager->flushLatch);
+		pthread_join(bufferManager->flusher, NULL);
+		bufferManager->flusherRunning = false;
+	}
+	pthread_mutex_destroy(&bufferManager->flushLatch);
+	pthread_cond_destroy(&bufferManager->flushCond);
+}
+
+/*
+1. This method returns the name of the warm-up list of the page file pageFileName, the caller frees it
+*/
+char *warmUpFileName(const char *pageFileName)
+{
+	char *name = (char *)malloc(strlen(pageFileName) + strlen(BM_WARMUP_SUFFIX) + 1);
+	if (name != NULL)
+		sprintf(name, "%s%s", pageFileName, BM_WARMUP_SUFFIX);
+	return name;
+}
+
+/*
+1. This method orders page numbers for qsort
+*/
+int comparePageNumbers(const void *a, const void *b)
+{
+	PageNumber left = *(const PageNumber *)a;
+	PageNumber right = *(const PageNumber *)b;
+	return (left > right) - (left < right);
+}
+
+/*
+1. This method saves the numbers of the pages of the file fileId that are in the pool to the file's warm-up list, sorted
+2. The list is written to a temporary file that then replaces the old list, so a crash leaves one list or the other whole
+3. Saving is best effort, a list that cannot be written only leaves the next start cold
+*/
+void saveWarmUpList(BufferManager *bufferManager, const int fileId)
+{
+	char *name = bufferManager->warmUpFiles[fileId];
+	char *tempName = (char *)malloc(strlen(name) + 5);
+	PageNumber *pages;
+	WarmUpHeader header;
+	FILE *file = NULL;
+	bool saved = false;
+	int i;
+
+	pthread_rwlock_rdlock(&bufferManager->framesLatch);
+	pages = (PageNumber *)malloc(sizeof(PageNumber) * bufferManager->numFrames);
+	header.magic = BM_WARMUP_MAGIC;
+	header.count = 0;
+	for (i = 0; pages != NULL && i < bufferManager->numFrames; i++)
+	{
+		PageNumber key = bufferManager->frames[i]->pageNumber;
+		if (key != NO_PAGE && KEY_FILE_ID(key) == fileId)
+			pages[header.count++] = KEY_PAGE_NUMBER(key);
+	}
+	pthread_rwlock_unlock(&bufferManager->framesLatch);
+	if (pages != NULL && tempName != NULL)
+	{
+		qsort(pages, header.count, sizeof(PageNumber), comparePageNumbers);
+		sprintf(tempName, "%s.tmp", name);
+		file = fopen(tempName, "wb");
+	}
+	if (file != NULL)
+	{
+		saved = (fwrite(&header, sizeof(WarmUpHeader), 1, file) == 1 &&
+				 fwrite(pages, sizeof(PageNumber), header.count, file) == (size_t)header.count);
+		saved = (fclose(file) == 0) && saved;
+		if (!saved || rename(tempName, name) != 0)
+			remove(tempName);
+	}
+	free(pages);
+	free(tempName);
+}
+
+/*
+1. This method stops the prefetcher thread if prefetchPages started one, waiting for the range it is loading, and frees its latches
+2. Ranges still queued are dropped
+*/
+void stopPrefetcher(BufferManager *bufferManager)
+{
+	if (bufferManager->prefetcherRunning)
+	{
+		pthread_mutex_lock(&bufferManager->prefetchLatch);
+		bufferManager->prefetcherStop = true;
+		pthread_cond_signal(&bufferManager->prefetchCond);
+		pthread_mutex_unlock(&bufferManager->prefetchLatch);
+		pthread_join(bufferManager->prefetcher, NULL);
+		bufferManager->prefetcherRunning = false;
+	}
+	// warm-ups still queued
+	for (; bufferManager->prefetchCount > 0; bufferManager->prefetchCount--)
+	{
+		free(bufferManager->prefetchQueue[bufferManager->prefetchHead].pages);
+		bufferManager->prefetchHead = (bufferManager->prefetchHead + 1) % BM_PREFETCH_QUEUE;
+	}
+	pthread_mutex_destroy(&bufferManager->prefetchLatch);
+	pthread_cond_destroy(&bufferManager->prefetchCond);
+	pthread_cond_destroy(&bufferManager->prefetchIdle);
+}
+
+/*
+1. This method fills the pool options with their defaults
+2. Used by initBufferPool; callers of initBufferPoolWithOptions start from it
+*/
+void initPoolOptions(BM_PoolOptions *const options)
+{
+	options->ioMode = SM_IO_BUFFERED;
+	options->ioQueueDepth = 32;
+	options->backgroundFlush = 0;
+	options->flushInterval = 100;
+	options->dirtyHighRatio = 50;
+	options->dirtyLowRatio = 10;
+	options->hugePages = 0;
+	options->pageSize = PAGE_SIZE;
+	options->warmUp = 0;
+}
+
+/*
+1. This method closes every page file open in the pool and frees their handles
+*/
+void closePoolFiles(BufferManager *bufferManager)
+{
+	int i;
+	for (i = 0; i < BM_MAX_PAGE_FILES; i++)
+	{
+		if (bufferManager->files[i] == NULL)
+			continue;
+		closePageFile(bufferManager->files[i]);
+		free(bufferManager->files[i]);
+		bufferManager->files[i] = NULL;
+		free(bufferManager->warmUpFiles[i]);
+		bufferManager->warmUpFiles[i] = NULL;
+	}
+}
+
+/*
+Jason Scott - A20436737
+1. This method initiazatizes buffer pool with the default options
+*/
+RC initBufferPool(BM_BufferPool *const bm, const char *const pageFileName, const int numPages, ReplacementStrategy strategy, void *stratData)
+{
+	BM_PoolOptions options;
+	initPoolOptions(&options);
+	return initBufferPoolWithOptions(bm, pageFileName, numPages, strategy, stratData, &options);
+}
+
+// the warm-up list is loaded through the prefetcher, defined with it further down
+void loadWarmUpList(BM_BufferPool *const bm, BufferManager *bufferManager, const int fileId, int maxPages);
+
+/*
+Jason Scott - A20436737
+1. This method initiazatizes buffer pool
+2. Opens the existing page file once with the I/O backend from options; the handle stays open until shutdownBufferPool
+3. Creates the new frames
+4. Without a page file (pageFileName NULL) the pool only serves files attached by attachPageFile, its frames have options->pageSize bytes
+*/
+RC initBufferPoolWithOptions(BM_BufferPool *const bm, const char *const pageFileName, const int numPages, ReplacementStrategy strategy, void *stratData, BM_PoolOptions *const options)
+{
+	FrameSegment *segment = NULL;
+	int i;
+	int zero = 0;
+	int pageCount = numPages;
+
+	BufferManager *bufferManager = GetBufferManager();
+	bufferManager->start = NULL;
+	pthread_mutex_init(&bufferManager->poolLatch, NULL);
+	pthread_mutex_init(&bufferManager->ioEngineLatch, NULL);
+	pthread_mutex_init(&bufferManager->filesLatch, NULL);
+	pthread_rwlock_init(&bufferManager->framesLatch, NULL);
+	pthread_mutex_init(&bufferManager->prefetchLatch, NULL);
+	pthread_cond_init(&bufferManager->prefetchCond, NULL);
+	pthread_cond_init(&bufferManager->prefetchIdle, NULL);
+	bufferManager->prefetchFileId = -1;
+	RC openPageReturnCode = RC_OK;
+	if (pageFileName != NULL)
+		openPageReturnCode = openPageFileWithMode((char *)pageFileName, bufferManager->files[0], options->ioMode);
+	else if (options->pageSize < SM_MIN_PAGE_SIZE || options->pageSize > SM_MAX_PAGE_SIZE || (options->pageSize & (options->pageSize - 1)) != 0)
+		openPageReturnCode = RC_INVALID_PAGE_SIZE;
+	if (openPageReturnCode != RC_OK)
+	{
+		pthread_mutex_destroy(&bufferManager->poolLatch);
+		pthread_mutex_destroy(&bufferManager->ioEngineLatch);
+		pthread_mutex_destroy(&bufferManager->filesLatch);
+		pthread_rwlock_destroy(&bufferManager->framesLatch);
+		stopPrefetcher(bufferManager);
+		free(bufferManager->files[0]);
+		free(bufferManager);
+		return openPageReturnCode;
+	}
+	// an eviction keeps a write-back and a read in flight together
+	bufferManager->ioMode = options->ioMode;
+	bufferManager->ioQueueDepth = (options->ioQueueDepth > 0 && options->ioQueueDepth < 2) ? 2 : options->ioQueueDepth;
+	if (pageFileName != NULL)
+	{
+		initAsyncIO(bufferManager->files[0], bufferManager->ioQueueDepth);
+		// frames take the page size recorded in the file header
+		bufferManager->pageSize = bufferManager->files[0]->pageSize;
+	}
+	else
+	{
+		free(bufferManager->files[0]);
+		bufferManager->files[0] = NULL;
+		bufferManager->pageSize = options->pageSize;
+	}
+	bufferManager->writeBackPage = NULL;
+	if (posix_memalign((void **)&bufferManager->writeBackPage, SM_IO_ALIGNMENT, bufferManager->pageSize) != 0)
+		bufferManager->writeBackPage = NULL;
+	bufferManager->writeBackPending = false;
+	bufferManager->lfuBuckets = NULL;
+	bufferManager->lrukFrameHistory = NULL;
+	bufferManager->lrukRetained = NULL;
+	bufferManager->lrukRetainedHistory = NULL;
+	bufferManager->lrukRetainedSlots = NULL;
+	bufferManager->arcGhosts = NULL;
+	bufferManager->arcGhostTable.slots = NULL;
+	bufferManager->numFrames = pageCount;
+	bufferManager->numDirty = 0;
+	bufferManager->hugePages = options->hugePages;
+	bufferManager->frameCapacity = pageCount;
+	bufferManager->frames = (BufferFrame **)malloc(sizeof(BufferFrame *) * pageCount);
+	if (bufferManager->frames != NULL && (segment = createFrameSegment(bufferManager, pageCount)) != NULL)
+		bufferManager->segments = segment;
+	if (segment == NULL ||
+		!createPageTablePartitions(bufferManager, pageCount) ||
+		(strategy == RS_ARC && !createARCGhosts(bufferManager, pageCount)) ||
+		(strategy == RS_LFU && !createLFUBuckets(bufferManager, pageCount, (BM_LFUData *)stratData)) ||
+		(strategy == RS_LRU_K && !createLRUKHistory(bufferManager, pageCount, (BM_LRUKData *)stratData)))
+	{
+		freeFrameSegments(bufferManager);
+		freePageTablePartitions(bufferManager);
+		free(bufferManager->lfuBuckets);
+		freeLRUKHistory(bufferManager);
+		freeARCGhosts(bufferManager);
+		closePoolFiles(bufferManager);
+		free(bufferManager->writeBackPage);
+		pthread_mutex_destroy(&bufferManager->poolLatch);
+		pthread_mutex_destroy(&bufferManager->ioEngineLatch);
+		pthread_mutex_destroy(&bufferManager->filesLatch);
+		pthread_rwlock_destroy(&bufferManager->framesLatch);
+		stopPrefetcher(bufferManager);
+		free(bufferManager);
+		return RC_ERROR;
+	}
+	for (i = 0; i < pageCount; i++)
+	{
+		bufferManager->frames[i] = &segment->frames[i];
+		createBufferFrame(bufferManager, bufferManager->frames[i], segment->arena + (size_t)i * bufferManager->pageSize);
+	}
+	if (strategy == RS_LFU)
+		lfuAddEmptyFrames(bufferManager);
+	else if (strategy == RS_LRU_K)
+		lrukAttachFrames(bufferManager);
+	else if (strategy == RS_ARC)
+		arcAddEmptyFrames(bufferManager);
+	bufferManager->strategyData = stratData;
+	bufferManager->tail = bufferManager->head;
+	bufferManager->clockHand = bufferManager->head;
+	bufferManager->count = zero;
+	bufferManager->numRead = zero;
+	bufferManager->numWrite = zero;
+	bm->numPages = pageCount;
+	bm->pageFile = (char *)pageFileName;
+	bm->strategy = AssignStrategy(strategy);
+	bm->mgmtData = AssignBufferManager(bufferManager);
+	// the flusher works on the complete pool
+	if (!startFlusher(bufferManager, options))
+	{
+		shutdownBufferPool(bm);
+		return RC_ERROR;
+	}
+	// an empty pool can take the whole list
+	bufferManager->warmUp = options->warmUp;
+	if (bufferManager->warmUp && pageFileName != NULL)
+	{
+		bufferManager->warmUpFiles[0] = warmUpFileName(pageFileName);
+		loadWarmUpList(bm, bufferManager, 0, bufferManager->numFrames);
+	}
+	return RC_OK;
+}
+
+/*
+Jason Scott - A20436737
+1. This method checks for dirty pages
+2. All dirtypages with fix count zero are sorted by page number and written to disk through the pool's open file handles,
+each run of adjacent pages with one vectored write
+3. The page file headers are written back afterwards if they changed (checkpoint)
+4. Then every file is synced once, which makes the pages evictions and the flusher wrote since the last checkpoint durable as well
+*/
+RC forceFlushPool(BM_BufferPool *const bm)
+{
+	if (!CheckValidManagementData(bm))
+		return RC_BUFFER_POOL_NOT_INIT;
+	BufferManager *bufferManager = getunpinPageManager(bm);
+	RC returnCode = flushDirtyFrames(bufferManager, bufferManager->numFrames, -1);
+	int i;
+	if (returnCode != RC_OK)
+		return returnCode;
+	pthread_mutex_lock(&bufferManager->filesLatch);
+	for (i = 0; i < BM_MAX_PAGE_FILES && returnCode == RC_OK; i++)
+		if (bufferManager->files[i] != NULL)
+			returnCode = forceFileHeader(bufferManager->files[i]);
+	// one sync per file after all of its writes, not one per page
+	for (i = 0; i < BM_MAX_PAGE_FILES && returnCode == RC_OK; i++)
+		if (bufferManager->files[i] != NULL)
+			returnCode = syncPageFile(bufferManager->files[i]);
+	pthread_mutex_unlock(&bufferManager->filesLatch);
+	return returnCode;
+}
+
+/*
+Jason Scott - A20436737
+1. This method destroyes buffer pool
+2. Utilizes forceflush method to write all the dirtyPages back again, before destroying
+3. It frees up the buffer pool's resources
+*/
+RC shutdownBufferPool(BM_BufferPool *const bm)
+{
+	FrameSegment *segment;
+	int i;
+	// checks it exists/init and is good to go
+	if (!CheckValidManagementData(bm))
+		return RC_BUFFER_POOL_NOT_INIT;
+	// load the mgmt of buffer pool
+	BufferManager *bufferManager = bm->mgmtData;
+	stopPrefetcher(bufferManager);
+	stopFlusher(bufferManager);
+	// calls upon forceflush method for dirty pages with fix count 0 to be written
+	forceFlushPool(bm);
+	for (i = 0; i < BM_MAX_PAGE_FILES; i++)
+		if (bufferManager->warmUpFiles[i] != NULL)
+			saveWarmUpList(bufferManager, i);
+	// frames a shrink took out of the pool included
+	for (segment = bufferManager->segments; segment != NULL; segment = segment->next)
+		for (i = 0; i < segment->numFrames; i++)
+			pthread_rwlock_destroy(&segment->frames[i].latch);
+	// the frames and all page data go with the segments
+	freeFrameSegments(bufferManager);
+	closePoolFiles(bufferManager);
+	free(bufferManager->writeBackPage);
+	freePageTablePartitions(bufferManager);
+	free(bufferManager->lfuBuckets);
+	freeLRUKHistory(bufferManager);
+	freeARCGhosts(bufferManager);
+	pthread_mutex_destroy(&bufferManager->poolLatch);
+	pthread_mutex_destroy(&bufferManager->ioEngineLatch);
+	pthread_mutex_destroy(&bufferManager->filesLatch);
+	pthread_rwlock_destroy(&bufferManager->framesLatch);
+	CleanBufferPool(bufferManager, bm);
+	return RC_OK;
+}
+
+/* Darek Nowak A20497998 + Ramya Krishnan(rkrishnan1@hawk.iit.edu) - A20506653
+// This function will pass trhough a page, check if it's in the buffer, and then mark it dirty so that it can't be removed until it's written back to disk.
+//  1. Searches for given page
+//  2. If found in buffer, marks as dirty
+*/
+RC markDirty(BM_BufferPool *const bm, BM_PageHandle *const page)
+{
+	int flag = 1;
+	// check buffer pool exists
+	if (!CheckValidManagementData(bm))
+		return RC_BUFFER_POOL_NOT_INIT;
+
+	BufferManager *bufferManager = bm->mgmtData;
+	BufferFrame *frame = findPinnedFrame(bufferManager, handleKey(page));
+	// case it exists, mark dirty
+	if (frame != NULL && flag)
+		markFrameDirty(bufferManager, frame);
+
+	return RC_OK;
+}
+
+/* Darek Nowak A20497998 + Ramya Krishnan(rkrishnan1@hawk.iit.edu) - A20506653
+// 1. Checks to see if page is in the buffer pool
+// 2. If it is, decrement total count of frame used in buffer
+*/
+RC unpinPage(BM_BufferPool *const bm, BM_PageHandle *const page)
+{
+	BufferManager *bufferManager = getunpinPageManager(bm);
+	BufferFrame *frame = findPinnedFrame(bufferManager, handleKey(page));
+	// decrement total count of frame used in buffer
+	if (frame != NULL)
+		frame->count--;
+
+	return RC_OK;
+}
+
+/* Darek Nowak A20497998 + Ramya Krishnan(rkrishnan1@hawk.iit.edu) - A20506653
+// 1. Checks if the page exists, pinning it while it is written so it is not replaced meanwhile
+// 2. If it does, it will check to see if it is dirty, under the frame's shared latch
+// 3. If it is dirty, writes to disk and increments writeIO count
+// 4. A page still being written back from a reused frame is on its way to disk already, that write is waited for
+*/
+RC forcePage(BM_BufferPool *const bm, BM_PageHandle *const page)
+{
+	if (!CheckValidManagementData(bm))
+		return RC_BUFFER_POOL_NOT_INIT;
+	BufferManager *bufferManager = getunpinPageManager(bm);
+	BufferFrame *transit;
+	PageNumber key = handleKey(page);
+	BufferFrame *frame = CheckIfPageExists(bufferManager, key, &transit);
+	RC writeBlockReturnCode = RC_OK;
+
+	if (transit != NULL)
+		waitForFrame(transit);
+	if (frame == NULL)
+		return RC_OK;
+	pthread_rwlock_rdlock(&frame->latch);
+	// dirty checking of the frame holding the page
+	if (frame->pageNumber == key && clearFrameDirty(bufferManager, frame))
+	{
+		writeBlockReturnCode = writeBlock(KEY_PAGE_NUMBER(key), keyFile(bufferManager, key), frame->data);
+		// case we can write, then write to disk and continue
+		if (writeBlockReturnCode == RC_OK)
+		{
+			bufferManager->numWrite++;
+			bufferManager->numFlushWrites++;
+		}
+		else
+			markFrameDirty(bufferManager, frame);
+	}
+	pthread_rwlock_unlock(&frame->latch);
+	frame->count--;
+	return writeBlockReturnCode;
+}
+
+/*
+1. This method latches a page the caller has pinned, shared (exclusive = 0) for readers or exclusive for writers
+2. The latch orders the threads working on the page's content; pins never wait for it, but writing the page out does,
+so a page is not flushed while an exclusive holder is changing it
+3. Returns RC_IM_KEY_NOT_FOUND if the page is not in the pool
+*/
+RC latchPage(BM_BufferPool *const bm, BM_PageHandle *const page, const int exclusive)
+{
+	if (!CheckValidManagementData(bm))
+		return RC_BUFFER_POOL_NOT_INIT;
+	BufferFrame *frame = findPinnedFrame(getunpinPageManager(bm), handleKey(page));
+	if (frame == NULL)
+		return RC_IM_KEY_NOT_FOUND;
+	if (exclusive)
+		pthread_rwlock_wrlock(&frame->latch);
+	else
+		pthread_rwlock_rdlock(&frame->latch);
+	return RC_OK;
+}
+
+/*
+1. This method releases the latch taken by latchPage, the page is still pinned afterwards
+2. Returns RC_IM_KEY_NOT_FOUND if the page is not in the pool
+*/
+RC unlatchPage(BM_BufferPool *const bm, BM_PageHandle *const page)
+{
+	if (!CheckValidManagementData(bm))
+		return RC_BUFFER_POOL_NOT_INIT;
+	BufferFrame *frame = findPinnedFrame(getunpinPageManager(bm), handleKey(page));
+	if (frame == NULL)
+		return RC_IM_KEY_NOT_FOUND;
+	pthread_rwlock_unlock(&frame->latch);
+	return RC_OK;
+}
+
+/*
+1. This method counts a pin for the strategies that keep time in pins: LFU ages its counts, LRU-K ticks its clock
+2. The caller holds the pool latch
+*/
+void countPin(BM_BufferPool *const bm, BufferManager *bufferManager)
+{
+	if (bm->strategy == RS_LFU)
+		lfuCountPin(bufferManager);
+	// every pin is one tick of the LRU-K clock
+	else if (bm->strategy == RS_LRU_K)
+		bufferManager->lrukClock++;
+}
+
+/*
+1. This method does the replacement strategy's bookkeeping for a hit on frame
+2. The caller holds the pool latch, except for CLOCK and FIFO which need none
+*/
+void recordHit(BM_BufferPool *const bm, BufferManager *bufferManager, BufferFrame *frame)
+{
+	// the first pin of a prefetched page is its load, the strategy placed it then
+	if (frame->prefetched && __atomic_exchange_n(&frame->prefetched, 0, __ATOMIC_SEQ_CST))
+	{
+		bufferManager->numPrefetchHits++;
+		return;
+	}
+	// someone else wants the page too, the scan ring leaves it to the pool
+	if (frame->inRing)
+		frame->inRing = 0;
+	// required and mentioned LRU
+	if (bm->strategy == RS_LRU)
+	{
+		bufferManager->tail = bufferManager->head->nextFrame;
+		bufferManager->head = frame;
+	}
+	// CLOCK only marks the frame, the ring is not reordered on a hit
+	else if (bm->strategy == RS_CLOCK)
+		frame->refBit = 1;
+	else if (bm->strategy == RS_LFU)
+		lfuTouch(bufferManager, frame);
+	else if (bm->strategy == RS_LRU_K)
+		lrukReference(bufferManager, frame);
+	// an ARC hit in T1 or T2 makes the page frequent
+	else if (bm->strategy == RS_ARC)
+	{
+		arcRemove(frame);
+		arcPush(&bufferManager->arcT2, frame);
+	}
+}
+
+/*
+1. This method waits for frame like waitForFrame on behalf of a pin, counting the wait and its time in the pool's statistics
+*/
+void waitForPin(BufferManager *bufferManager, BufferFrame *frame)
+{
+	struct timespec start, end;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	waitForFrame(frame);
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	bufferManager->numPinWaits++;
+	bufferManager->pinWaitMicros += (int64_t)(end.tv_sec - start.tv_sec) * 1000000 + (end.tv_nsec - start.tv_nsec) / 1000;
+}
+
+/*
+1. This method hands a frame pinned by a hit to the caller once its page is readable
+2. If another thread is still loading the page it waits for it; if that load failed the pin is dropped and the load's error returned
+*/
+RC finishPin(BufferManager *bufferManager, BufferFrame *frame, BM_PageHandle *const page, const PageNumber pageNum)
+{
+	if (frame->loading)
+		waitForPin(bufferManager, frame);
+	// a failed load leaves the frame without the page
+	if (frame->pageNumber != pageNum)
+	{
+		RC loadReturnCode = frame->ioResult;
+		frame->count--;
+		return loadReturnCode;
+	}
+	setPageHandle(page, pageNum, frame->data);
+	return RC_OK;
+}
+
+/*
+1. This method claims the next empty frame of an LRU or FIFO pool that is still filling up
+2. Empty frames follow the head, the head moves past the claimed frame
+3. Returns NULL if the frame cannot be claimed
+*/
+BufferFrame *fillFrame(BufferManager *bufferManager)
+{
+	BufferFrame *frame = bufferManager->head;
+	// LRU hits move the head, the next empty frame may lie further on
+	while (frame->pageNumber != NO_PAGE && frame->nextFrame != bufferManager->head)
+		frame = frame->nextFrame;
+	if (!claimFrame(bufferManager, frame))
+		return NULL;
+	if (frame->nextFrame != bufferManager->head)
+		bufferManager->head = frame->nextFrame;
+	return frame;
+}
+
+/*
+1. This method starts the write-back of the page a claimed frame held on the async I/O engine
+2. The data is copied to the pool's write-back page, so the frame can be refilled while the write is in flight
+3. readPageOverlapped waits for the write together with the read of the new page; the caller holds ioEngineLatch
+*/
+RC startWriteBack(BufferManager *bufferManager, SM_FileHandle *sm_FileHandle, BufferFrame *frame, const PageNumber oldPage)
+{
+	memcpy(bufferManager->writeBackPage, frame->data, bufferManager->pageSize);
+	RC submitReturnCode = submitWriteBlock(oldPage, sm_FileHandle, bufferManager->writeBackPage, bufferManager->writeBackPage);
+	if (submitReturnCode != RC_OK)
+		return submitReturnCode;
+	bufferManager->writeBackPending = true;
+	return RC_OK;
+}
+
+/*
+1. This method reads pageNumber into data through the async I/O engine
+2. A write-back started by startWriteBack is completed in the same wait, so both I/Os overlap
+3. Updates numRead/numWrite; returns the result of the read, the write-back's failure goes to writeReturnCode
+*/
+RC readPageOverlapped(BufferManager *bufferManager, SM_FileHandle *sm_FileHandle, const PageNumber pageNumber, char *data, RC *writeReturnCode)
+{
+	SM_IOCompletion completions[2];
+	bool writePending = bufferManager->writeBackPending;
+	int pending = 0;
+	int numCompleted;
+	int i;
+	RC result = submitReadBlock(pageNumber, sm_FileHandle, data, data);
+	if (result == RC_OK)
+		pending++;
+	if (writePending)
+		pending++;
+	bufferManager->writeBackPending = false;
+	while (pending > 0)
+	{
+		if (completeBlocks(sm_FileHandle, pending, completions, 2, &numCompleted) != RC_OK)
+		{
+			// the outcome is unknown, the page is not taken as written
+			if (writePending)
+				*writeReturnCode = RC_ERROR;
+			return RC_ERROR;
+		}
+		for (i = 0; i < numCompleted; i++)
+		{
+			if (completions[i].tag == bufferManager->writeBackPage)
+			{
+				writePending = false;
+				if (completions[i].rc == RC_OK)
+				{
+					bufferManager->numWrite++;
+					bufferManager->numEvictionWrites++;
+				}
+				else
+					*writeReturnCode = completions[i].rc;
+			}
+			else if (completions[i].rc == RC_OK)
+				bufferManager->numRead++;
+			else if (result == RC_OK)
+				result = completions[i].rc;
+		}
+		pending -= numCompleted;
+	}
+	return result;
+}
+
+/*
+1. This method does the I/O of a claimed frame, outside the pool latch: the write-back of the page it held if that was dirty, then the read of its new page
+2. The thread that gets the async engine copies the write-back aside and overlaps it with the read;
+threads finding the engine busy do both synchronously, so concurrent misses overlap each other instead
+3. Both pages are given by key; a write-back to another file than the read's is done synchronously, the engine belongs to one file
+4. Returns the first failure; writeReturnCode tells whether the write-back failed, the frame holds the old page again then
+*/
+RC transferFramePages(BufferManager *bufferManager, BufferFrame *frame, const PageNumber oldPage, bool wasDirty,
+					  const PageNumber pageNumber, RC *writeReturnCode)
+{
+	SM_FileHandle *sm_FileHandle = keyFile(bufferManager, pageNumber);
+	SM_FileHandle *oldFileHandle = wasDirty ? keyFile(bufferManager, oldPage) : sm_FileHandle;
+	RC readReturnCode;
+	*writeReturnCode = RC_OK;
+	ensureCapacity((KEY_PAGE_NUMBER(pageNumber) + 1), sm_FileHandle);
+	if (bufferManager->writeBackPage != NULL && oldFileHandle == sm_FileHandle && pthread_mutex_trylock(&bufferManager->ioEngineLatch) == 0)
+	{
+		if (wasDirty)
+			*writeReturnCode = startWriteBack(bufferManager, sm_FileHandle, frame, KEY_PAGE_NUMBER(oldPage));
+		if (*writeReturnCode == RC_OK)
+			readReturnCode = readPageOverlapped(bufferManager, sm_FileHandle, KEY_PAGE_NUMBER(pageNumber), frame->data, writeReturnCode);
+		else
+			readReturnCode = *writeReturnCode;
+		// the read may have overwritten the frame already, put back the page that could not be written
+		if (wasDirty && *writeReturnCode != RC_OK)
+		{
+			memcpy(frame->data, bufferManager->writeBackPage, bufferManager->pageSize);
+			readReturnCode = *writeReturnCode;
+		}
+		pthread_mutex_unlock(&bufferManager->ioEngineLatch);
+		return readReturnCode;
+	}
+	if (wasDirty)
+	{
+		*writeReturnCode = writeBlock(KEY_PAGE_NUMBER(oldPage), oldFileHandle, frame->data);
+		if (*writeReturnCode != RC_OK)
+			return *writeReturnCode;
+		bufferManager->numWrite++;
+		bufferManager->numEvictionWrites++;
+	}
+	readReturnCode = readBlock(KEY_PAGE_NUMBER(pageNumber), sm_FileHandle, frame->data);
+	if (readReturnCode == RC_OK)
+		bufferManager->numRead++;
+	return readReturnCode;
+}
+
+/*
+1. This method undoes the load of pageNum into frame after it failed, the frame is still latched exclusively
+2. The frame leaves the page table under the new page; if the page it held could not be written back it keeps that page,
+dirty and still listed, otherwise it is left empty
+3. Threads that pinned the new page meanwhile find the frame without it and return returnCode
+*/
+void abandonLoad(BufferManager *bufferManager, BufferFrame *frame, const PageNumber oldPage, bool keepOldPage,
+				 const PageNumber pageNum, RC returnCode)
+{
+	PageTablePartition *partition = pageTablePartition(bufferManager, pageNum);
+	frame->ioResult = returnCode;
+	pthread_mutex_lock(&partition->latch);
+	pageTableRemove(&partition->table, pageNum, frame);
+	frame->pageNumber = NO_PAGE;
+	pthread_mutex_unlock(&partition->latch);
+	if (keepOldPage)
+	{
+		partition = pageTablePartition(bufferManager, oldPage);
+		pthread_mutex_lock(&partition->latch);
+		markFrameDirty(bufferManager, frame);
+		frame->pageNumber = oldPage;
+		pthread_mutex_unlock(&partition->latch);
+	}
+}
+
+/*
+1.This method is used to pick the last recently used frame for a new page
+2. Claims the frame and moves tail and head past it
+3. Returns NULL if every frame is pinned
+*/
+BufferFrame *LRU(BM_BufferPool *const bm, BufferManager *bufferManager)
+{
+	BufferFrame *frame;
+	if (bm->numPages > bufferManager->count && (frame = fillFrame(bufferManager)) != NULL)
+		return frame;
+	frame = bufferManager->tail;
+	do
+	{
+		if (frame->count == 0)
+		{
+			// tail and head meet, the frame after the tail takes the page
+			if (bufferManager->tail == bufferManager->head && claimFrame(bufferManager, frame->nextFrame))
+			{
+				bufferManager->head = frame->nextFrame;
+				bufferManager->tail = frame;
+				return frame->nextFrame;
+			}
+			if (claimFrame(bufferManager, frame))
+			{
+				bufferManager->tail = frame->nextFrame;
+				return frame;
+			}
+		}
+		frame = frame->nextFrame;
+	} while (frame != bufferManager->tail);
+	return NULL;
+}
+
+/*
+1.This method is used to pick the FIFO frame for a new page
+2. The first frame from the tail on that can be claimed is taken, it becomes the head
+3. Returns NULL if every frame is pinned
+*/
+BufferFrame *FIFO(BM_BufferPool *const bm, BufferManager *mgmt)
+{
+	BufferFrame *bufferFrame;
+	if (bm->numPages > mgmt->count && (bufferFrame = fillFrame(mgmt)) != NULL)
+		return bufferFrame;
+	bufferFrame = mgmt->tail;
+	do
+	{
+		if (claimFrame(mgmt, bufferFrame))
+		{
+			mgmt->tail = bufferFrame->nextFrame;
+			mgmt->head = bufferFrame;
+			return bufferFrame;
+		}
+		bufferFrame = bufferFrame->nextFrame;
+	} while (bufferFrame != mgmt->tail);
+	return NULL;
+}
+
+/*
+1.This method is used to pick a frame by the CLOCK (second chance) strategy
+2. The clock hand persists in the buffer manager; unpinned frames with the reference bit set get it cleared and are passed over once,
+the first unpinned frame without it (or an empty frame) is claimed
+3. Returns NULL if every frame is pinned
+*/
+BufferFrame *CLOCK(BM_BufferPool *const bm, BufferManager *bufferManager)
+{
+	int i;
+	// two sweeps clear every reference bit, so an unpinned frame is found by then
+	for (i = 0; i < 2 * bm->numPages; i++)
+	{
+		BufferFrame *candidate = bufferManager->clockHand;
+		bufferManager->clockHand = candidate->nextFrame;
+		if (candidate->count != 0)
+			continue;
+		if (candidate->pageNumber == NO_PAGE || candidate->refBit == 0)
+		{
+			if (!claimFrame(bufferManager, candidate))
+				continue;
+			candidate->refBit = 1;
+			return candidate;
+		}
+		// second chance
+		candidate->refBit = 0;
+		bufferManager->clockSecondChances++;
+	}
+	return NULL;
+}
+
+/*
+1.This method is used to pick the least frequently used frame
+2. Frames are taken from the lowest frequency bucket first and, within a bucket, least recently used first; pinned frames are passed over
+3. Returns NULL if every frame is pinned
+*/
+BufferFrame *LFU(BM_BufferPool *const bm, BufferManager *bufferManager)
+{
+	LFUBucket *bucket;
+	for (bucket = bufferManager->lfuLowest; bucket != NULL; bucket = bucket->nextBucket)
+	{
+		BufferFrame *frame;
+		for (frame = bucket->last; frame != NULL; frame = frame->bucketPrev)
+		{
+			if (claimFrame(bufferManager, frame))
+			{
+				// the new page starts over with a single use
+				lfuUnlinkFrame(bufferManager, frame);
+				lfuInsertLoaded(bufferManager, frame);
+				return frame;
+			}
+		}
+	}
+	return NULL;
+}
+
+/*
+1.This method is used to pick the LRU-K victim frame chosen by lrukVictim
+2. The reference times of the replaced page are retained, those of the new page are restored if it was in the pool before
+3. Returns NULL if every frame is pinned
+*/
+BufferFrame *LRU_K(BM_BufferPool *const bm, BufferManager *bufferManager, const PageNumber pageNumber)
+{
+	BufferFrame *frame = lrukVictim(bufferManager);
+	if (frame == NULL)
+		return NULL;
+	lrukRetain(bufferManager, frame);
+	lrukLoad(bufferManager, frame, pageNumber);
+	return frame;
+}
+
+/*
+1.This method is used to pick a frame by ARC (adaptive replacement cache)
+2. T1 holds pages used once recently, T2 pages used at least twice; the ghost lists B1 and B2 remember pages replaced from them
+3. A miss on a B1 ghost grows the target size of T1, a miss on a B2 ghost shrinks it, so the pool tunes itself between recency and frequency
+4. Returns NULL if every frame is pinned
+*/
+BufferFrame *ARC(BM_BufferPool *const bm, BufferManager *bufferManager, const PageNumber pageNumber)
+{
+	int c = bm->numPages;
+	BufferFrame *ghost = pageTableFind(&bufferManager->arcGhostTable, pageNumber);
+	BufferFrame *frame = NULL;
+	ARCList *ghostList = NULL;
+	bool inB2 = (ghost != NULL && ghost->arcList == &bufferManager->arcB2);
+	int sizeB1 = bufferManager->arcB1.size;
+	int sizeB2 = bufferManager->arcB2.size;
+
+	if (ghost != NULL && !inB2)
+	{
+		// recency pays off, give T1 more room
+		int delta = (sizeB1 >= sizeB2) ? 1 : sizeB2 / sizeB1;
+		bufferManager->arcB1Hits++;
+		bufferManager->arcTarget = (bufferManager->arcTarget + delta < c) ? bufferManager->arcTarget + delta : c;
+	}
+	else if (inB2)
+	{
+		// frequency pays off, give T2 more room
+		int delta = (sizeB2 >= sizeB1) ? 1 : sizeB1 / sizeB2;
+		bufferManager->arcB2Hits++;
+		bufferManager->arcTarget = (bufferManager->arcTarget - delta > 0) ? bufferManager->arcTarget - delta : 0;
+	}
+	else if (bufferManager->arcT1.size + sizeB1 >= c)
+	{
+		// L1 is full: forget its oldest ghost, or if T1 fills the whole pool replace its LRU page without a ghost
+		if (bufferManager->arcT1.size < c)
+			arcForgetGhost(bufferManager, bufferManager->arcB1.last);
+		else
+			frame = arcClaimLRU(bufferManager, &bufferManager->arcT1);
+	}
+	else if (bufferManager->arcT1.size + bufferManager->arcT2.size + sizeB1 + sizeB2 >= 2 * c && sizeB2 > 0)
+		arcForgetGhost(bufferManager, bufferManager->arcB2.last);
+
+	if (frame == NULL && bufferManager->arcFree.size > 0)
+		frame = arcClaimLRU(bufferManager, &bufferManager->arcFree);
+	if (frame == NULL)
+		frame = arcReplace(bufferManager, inB2, &ghostList);
+	if (frame == NULL)
+		return NULL;
+
+	// the ghost of the new page goes before the replaced page becomes one
+	if (ghost != NULL)
+		arcForgetGhost(bufferManager, ghost);
+	if (ghostList != NULL && frame->previousPage != NO_PAGE)
+		arcAddGhost(bufferManager, ghostList, frame->previousPage);
+	arcRemove(frame);
+	arcPush((ghost != NULL) ? &bufferManager->arcT2 : &bufferManager->arcT1, frame);
+	return frame;
+}
+
+/*
+1. This method claims a frame for pageNum through the pool's replacement strategy, the caller holds the pool latch
+2. Returns NULL if every frame is pinned
+*/
+BufferFrame *pickFrame(BM_BufferPool *const bufferPool, BufferManager *bufferManager, const PageNumber pageNum)
+{
+	if (bufferPool->strategy == RS_LRU)
+		return LRU(bufferPool, bufferManager);
+	else if (bufferPool->strategy == RS_FIFO)
+		return FIFO(bufferPool, bufferManager);
+	else if (bufferPool->strategy == RS_CLOCK)
+		return CLOCK(bufferPool, bufferManager);
+	else if (bufferPool->strategy == RS_LFU)
+		return LFU(bufferPool, bufferManager);
+	else if (bufferPool->strategy == RS_LRU_K)
+		return LRU_K(bufferPool, bufferManager, pageNum);
+	else if (bufferPool->strategy == RS_ARC)
+		return ARC(bufferPool, bufferManager, pageNum);
+	return NULL;
+}
+
+/*
+1. This method does the replacement strategy's bookkeeping for frame, claimed by a scan ring to load pageNum in place of
+the page it loaded before, the caller holds the pool latch
+2. The frame keeps its place in LRU, FIFO and ARC and is not remembered as a ghost; CLOCK leaves its reference bit clear,
+LFU starts it over with a single use and LRU-K does not retain the history of the recycled page
+*/
+void recycleRingFrame(BM_BufferPool *const bufferPool, BufferManager *bufferManager, BufferFrame *frame, const PageNumber pageNum)
+{
+	if (bufferPool->strategy == RS_CLOCK)
+		frame->refBit = 0;
+	else if (bufferPool->strategy == RS_LFU)
+	{
+		lfuUnlinkFrame(bufferManager, frame);
+		lfuInsertLoaded(bufferManager, frame);
+	}
+	else if (bufferPool->strategy == RS_LRU_K)
+		lrukLoad(bufferManager, frame, pageNum);
+}
+
+/*
+1. This method claims a frame for pageNum on behalf of a scan ring, the caller holds the pool latch
+2. The frame of the ring's next slot is recycled if it still holds the page the ring loaded into it and nobody has it pinned
+or pinned it since; otherwise the replacement strategy picks a frame, which takes over the slot
+3. Returns NULL if every frame is pinned
+*/
+BufferFrame *ringFrame(BM_BufferPool *const bufferPool, BufferManager *bufferManager, BM_ScanRing *const ring, const PageNumber pageNum)
+{
+	ScanRing *scanRing = (ScanRing *)ring->mgmtData;
+	BufferFrame *frame = scanRing->frames[scanRing->next];
+	if (frame != NULL && frame->inRing && frame->pageNumber == scanRing->pages[scanRing->next] && claimFrame(bufferManager, frame))
+		recycleRingFrame(bufferPool, bufferManager, frame, pageNum);
+	else
+		frame = pickFrame(bufferPool, bufferManager, pageNum);
+	if (frame == NULL)
+		return NULL;
+	frame->inRing = 1;
+	scanRing->frames[scanRing->next] = frame;
+	scanRing->pages[scanRing->next] = pageNum;
+	scanRing->next = (scanRing->next + 1) % ring->numFrames;
+	return frame;
+}
+
+/*
+1. This method ends the load of pageNum into a claimed frame once its I/O is done, readReturnCode tells how the read went
+2. A failed load is undone; the old page leaves the page table once its write-back made it to disk
+3. The frame's latch is released, threads waiting for the page go on; the pin taken by the claim is left to the caller
+*/
+void finishLoad(BufferManager *bufferManager, BufferFrame *frame, const PageNumber oldPage, bool wasDirty,
+				RC writeReturnCode, const PageNumber pageNum, RC readReturnCode)
+{
+	if (readReturnCode != RC_OK)
+		abandonLoad(bufferManager, frame, oldPage, (wasDirty && writeReturnCode != RC_OK), pageNum, readReturnCode);
+	if (wasDirty && writeReturnCode == RC_OK)
+	{
+		// the old page is on disk now, it can be read from there again
+		PageTablePartition *partition = pageTablePartition(bufferManager, oldPage);
+		pthread_mutex_lock(&partition->latch);
+		pageTableRemove(&partition->table, oldPage, frame);
+		pthread_mutex_unlock(&partition->latch);
+	}
+	frame->loading = 0;
+	pthread_rwlock_unlock(&frame->latch);
+}
+
+/*
+1. This method counts the replacement of oldPage, the page a claimed frame held, in the pool's statistics; nothing if the frame was empty
+*/
+void countEviction(BufferManager *bufferManager, const PageNumber oldPage, bool wasDirty)
+{
+	if (oldPage == NO_PAGE)
+		return;
+	if (wasDirty)
+		bufferManager->numDirtyEvictions++;
+	else
+		bufferManager->numCleanEvictions++;
+}
+
+/*
+1.This method is used to load a page that missed into a frame of the replacement strategy (LRU, FIFO, CLOCK, LFU, LRU-K or ARC)
+2. The frame is chosen and the strategy's bookkeeping done under the pool latch; the I/O runs after it is released,
+so other threads' hits and misses go on meanwhile. The page is looked up again first, another thread may have loaded it
+3. Returns RC_NO_FREE_BUFFER_FRAME if every frame is pinned, otherwise RC_OK if the write-back of a dirty victim and the read of the new page succeeded;
+transit is set instead if the page is still being written back from another frame, or if the only frames not pinned by
+callers are being prefetched; the caller waits for that frame and tries again
+4. With a scan ring the frame comes from the ring, see ringFrame
+*/
+RC CheckReplacementStrategy(BM_PageHandle *const page, BufferManager *bufferManager, const PageNumber pageNum,
+							BufferFrame **transit, BM_BufferPool *const bufferPool, BM_ScanRing *const ring)
+{
+	BufferFrame *frame = NULL;
+	PageNumber oldPage;
+	bool wasDirty;
+	bool installed;
+	RC writeReturnCode;
+	RC readReturnCode;
+
+	pthread_mutex_lock(&bufferManager->poolLatch);
+	countPin(bufferPool, bufferManager);
+	frame = CheckIfPageExists(bufferManager, pageNum, transit);
+	if (frame != NULL || *transit != NULL)
+	{
+		if (frame != NULL)
+		{
+			bufferManager->numHits++;
+			recordHit(bufferPool, bufferManager, frame);
+		}
+		pthread_mutex_unlock(&bufferManager->poolLatch);
+		return (frame != NULL) ? finishPin(bufferManager, frame, page, pageNum) : RC_OK;
+	}
+	frame = (ring != NULL) ? ringFrame(bufferPool, bufferManager, ring, pageNum) : pickFrame(bufferPool, bufferManager, pageNum);
+	if (frame == NULL)
+	{
+		int i;
+		// a frame whose load is in flight may be a prefetch that leaves it unpinned, wait for it and try again
+		for (i = 0; i < bufferManager->numFrames && *transit == NULL; i++)
+			if (bufferManager->frames[i]->loading && bufferManager->frames[i]->prefetched)
+				*transit = bufferManager->frames[i];
+		pthread_mutex_unlock(&bufferManager->poolLatch);
+		return (*transit != NULL) ? RC_OK : RC_NO_FREE_BUFFER_FRAME;
+	}
+	oldPage = frame->previousPage;
+	wasDirty = (clearFrameDirty(bufferManager, frame) && oldPage != NO_PAGE);
+	installed = installPage(bufferManager, frame, pageNum);
+	bufferManager->numMisses++;
+	countEviction(bufferManager, oldPage, wasDirty);
+	pthread_mutex_unlock(&bufferManager->poolLatch);
+
+	readReturnCode = transferFramePages(bufferManager, frame, oldPage, wasDirty, pageNum, &writeReturnCode);
+	if (readReturnCode == RC_OK && !installed)
+		readReturnCode = RC_ERROR;
+	finishLoad(bufferManager, frame, oldPage, wasDirty, writeReturnCode, pageNum, readReturnCode);
+	if (readReturnCode != RC_OK)
+	{
+		frame->count--;
+		return readReturnCode;
+	}
+	setPageHandle(page, pageNum, frame->data);
+	return RC_OK;
+}
+
+/*
+1. This method is the body of pinFilePage and pinPageWithRing, it pins the page with key pageNum; ring is NULL for pinFilePage
+*/
+RC pinPageThrough(BM_BufferPool *const bm, BM_ScanRing *const ring, BM_PageHandle *const page, const PageNumber pageNum)
+{
+	if (!CheckValidManagementData(bm))
+		return RC_BUFFER_POOL_EXIST;
+
+	BufferManager *bufferManager = bm->mgmtData;
+	if (keyFile(bufferManager, pageNum) == NULL)
+		return RC_FILE_HANDLE_NOT_INIT;
+	for (;;)
+	{
+		BufferFrame *transit;
+		BufferFrame *frame = CheckIfPageExists(bufferManager, pageNum, &transit);
+		RC returnCode = RC_OK;
+		if (frame != NULL)
+		{
+			bufferManager->numHits++;
+			if (bm->strategy == RS_CLOCK || bm->strategy == RS_FIFO)
+				recordHit(bm, bufferManager, frame);
+			else
+			{
+				pthread_mutex_lock(&bufferManager->poolLatch);
+				countPin(bm, bufferManager);
+				recordHit(bm, bufferManager, frame);
+				pthread_mutex_unlock(&bufferManager->poolLatch);
+			}
+			return finishPin(bufferManager, frame, page, pageNum);
+		}
+		// the page file stays open in the buffer manager, so no open/close per pin
+		if (transit == NULL)
+			returnCode = CheckReplacementStrategy(page, bufferManager, pageNum, &transit, bm, ring);
+		if (transit == NULL)
+			return returnCode;
+		// the page is still being written back from a frame that holds another page by now
+		waitForPin(bufferManager, transit);
+	}
+}
+
+/* Darek Nowak A20497998 + Ramya Krishnan(rkrishnan1@hawk.iit.edu) - A20506653
+// 1. Looks the page up in the page table; a hit pins it without the pool latch (the strategy's bookkeeping takes it, except for CLOCK and FIFO)
+// 2. A miss passes through CheckReplacementStrategy() in order to figure out which strategy it'll pin(LRU, FIFO, CLOCK, LFU, LRU-K or ARC)
+// 3. Safe to call from several threads at once
+*/
+RC pinPage(BM_BufferPool *const bm, BM_PageHandle *const page, const PageNumber pageNum)
+{
+	return pinFilePage(bm, 0, page, pageNum);
+}
+
+/*
+1. This method pins page pageNum of the page file fileId, one of the files sharing the pool (0 is the pool's own file)
+2. Returns RC_READ_NON_EXISTING_PAGE for a page number out of range, RC_FILE_HANDLE_NOT_INIT if no file has the id
+*/
+RC pinFilePage(BM_BufferPool *const bm, const int fileId, BM_PageHandle *const page, const PageNumber pageNum)
+{
+	if (fileId < 0 || fileId >= BM_MAX_PAGE_FILES)
+		return RC_FILE_HANDLE_NOT_INIT;
+	if (pageNum < 0 || (pageNum >> BM_FILE_ID_SHIFT) != 0)
+		return RC_READ_NON_EXISTING_PAGE;
+	return pinPageThrough(bm, NULL, page, PAGE_KEY(fileId, pageNum));
+}
+
+/*
+1. This method pins pageNum of the ring's file like pinFilePage; a miss loads the page into a frame of the scan ring instead of one the replacement strategy picks
+2. Pages already in the pool are hits as usual
+*/
+RC pinPageWithRing(BM_BufferPool *const bm, BM_ScanRing *const ring, BM_PageHandle *const page, const PageNumber pageNum)
+{
+	if (ring == NULL || ring->mgmtData == NULL)
+		return RC_ERROR;
+	if (pageNum < 0 || (pageNum >> BM_FILE_ID_SHIFT) != 0)
+		return RC_READ_NON_EXISTING_PAGE;
+	return pinPageThrough(bm, ring, page, PAGE_KEY(ring->fileId, pageNum));
+}
+
+/*
+1. This method tells whether pageNum is listed in the page table, loaded, loading or still being written back
+*/
+bool pageIsBuffered(BufferManager *bufferManager, const PageNumber pageNum)
+{
+	PageTablePartition *partition = pageTablePartition(bufferManager, pageNum);
+	bool buffered;
+	pthread_mutex_lock(&partition->latch);
+	buffered = (pageTableFind(&partition->table, pageNum) != NULL) ? true : false;
+	pthread_mutex_unlock(&partition->latch);
+	return buffered;
+}
+
+/*
+1. This method ends a prefetch read and drops the pin of its claim, the page stays in the pool unpinned
+*/
+void finishPrefetch(BufferManager *bufferManager, PrefetchLoad *load, RC readReturnCode)
+{
+	if (readReturnCode == RC_OK)
+		bufferManager->numRead++;
+	load->done = true;
+	finishLoad(bufferManager, load->frame, load->oldPage, false, RC_OK, load->pageNumber, readReturnCode);
+	load->frame->count--;
+}
+
+/*
+1. This method loads the pages startPage .. startPage + count - 1 that are in the file but not in the pool, on the prefetcher thread
+2. Frames are claimed and the pages listed as loading first, so pins of them from now on wait for the read instead of issuing their own
+3. Frames whose old page is dirty are written back and loaded one at a time; the other reads all go to the async engine
+together and each frame is released as its read completes, without the engine every read is synchronous
+4. Stops early once every frame is pinned; with a scan ring the frames come from the ring, see ringFrame
+5. startPage is a key, the pages are those of its file
+*/
+void prefetchRange(BM_BufferPool *const bm, BufferManager *bufferManager, BM_ScanRing *const ring, const PageNumber startPage, int count)
+{
+	SM_FileHandle *fh = keyFile(bufferManager, startPage);
+	PrefetchLoad *loads = (PrefetchLoad *)malloc(sizeof(PrefetchLoad) * count);
+	SM_IOCompletion completions[BM_PREFETCH_COMPLETIONS];
+	int numLoads = 0;
+	int pending = 0;
+	int numCompleted;
+	int i, j;
+
+	if (loads == NULL)
+		return;
+	for (i = 0; i < count; i++)
+	{
+		PageNumber pageNum = startPage + i;
+		BufferFrame *frame;
+		PageNumber oldPage;
+		bool wasDirty;
+		bool installed;
+		if (KEY_PAGE_NUMBER(pageNum) >= __atomic_load_n(&fh->totalNumPages, __ATOMIC_ACQUIRE))
+			break;
+		pthread_mutex_lock(&bufferManager->poolLatch);
+		if (pageIsBuffered(bufferManager, pageNum))
+		{
+			pthread_mutex_unlock(&bufferManager->poolLatch);
+			continue;
+		}
+		frame = (ring != NULL) ? ringFrame(bm, bufferManager, ring, pageNum) : pickFrame(bm, bufferManager, pageNum);
+		if (frame == NULL)
+		{
+			pthread_mutex_unlock(&bufferManager->poolLatch);
+			break;
+		}
+		frame->prefetched = 1;
+		oldPage = frame->previousPage;
+		wasDirty = (clearFrameDirty(bufferManager, frame) && oldPage != NO_PAGE);
+		installed = installPage(bufferManager, frame, pageNum);
+		countEviction(bufferManager, oldPage, wasDirty);
+		pthread_mutex_unlock(&bufferManager->poolLatch);
+		if (!installed || wasDirty)
+		{
+			RC writeReturnCode = RC_OK;
+			RC readReturnCode = RC_ERROR;
+			if (installed)
+				readReturnCode = transferFramePages(bufferManager, frame, oldPage, wasDirty, pageNum, &writeReturnCode);
+			finishLoad(bufferManager, frame, oldPage, wasDirty, writeReturnCode, pageNum, readReturnCode);
+			frame->count--;
+			continue;
+		}
+		loads[numLoads].frame = frame;
+		loads[numLoads].pageNumber = pageNum;
+		loads[numLoads].oldPage = oldPage;
+		loads[numLoads].done = false;
+		numLoads++;
+	}
+
+	pthread_mutex_lock(&bufferManager->ioEngineLatch);
+	for (i = 0; i < numLoads || pending > 0;)
+	{
+		RC returnCode = RC_ASYNC_IO_QUEUE_FULL;
+		if (i < numLoads)
+			returnCode = submitReadBlock(KEY_PAGE_NUMBER(loads[i].pageNumber), fh, loads[i].frame->data, &loads[i]);
+		if (returnCode == RC_OK)
+		{
+			pending++;
+			i++;
+			continue;
+		}
+		// no engine, or it refused the page: read it right away
+		if (returnCode != RC_ASYNC_IO_QUEUE_FULL)
+		{
+			finishPrefetch(bufferManager, &loads[i], readBlock(KEY_PAGE_NUMBER(loads[i].pageNumber), fh, loads[i].frame->data));
+			i++;
+			continue;
+		}
+		if (completeBlocks(fh, 1, completions, BM_PREFETCH_COMPLETIONS, &numCompleted) != RC_OK)
+			break;
+		for (j = 0; j < numCompleted; j++)
+			finishPrefetch(bufferManager, (PrefetchLoad *)completions[j].tag, completions[j].rc);
+		pending -= numCompleted;
+	}
+	// the engine failed, the outcome of the reads left is unknown
+	for (i = 0; i < numLoads; i++)
+		if (!loads[i].done)
+			finishPrefetch(bufferManager, &loads[i], RC_ERROR);
+	pthread_mutex_unlock(&bufferManager->ioEngineLatch);
+	free(loads);
+}
+
+/*
+1. This method loads the count pages whose sorted keys are listed in pages, on the prefetcher thread
+2. Each run of adjacent pages is loaded like a prefetched range, see prefetchRange
+*/
+void prefetchPageList(BM_BufferPool *const bm, BufferManager *bufferManager, PageNumber *pages, const int count)
+{
+	int i, j;
+	for (i = 0; i < count; i = j)
+	{
+		for (j = i + 1; j < count && pages[j] == pages[j - 1] + 1; j++)
+			;
+		prefetchRange(bm, bufferManager, NULL, pages[i], j - i);
+	}
+}
+
+/*
+1. This method is the prefetcher thread of a pool, started by the first prefetchPages call
+2. It loads the queued page ranges in the order they were asked for and sleeps while the queue is empty
+3. It runs until shutdownBufferPool sets prefetcherStop
+*/
+void *runPrefetcher(void *arg)
+{
+	BM_BufferPool *bm = (BM_BufferPool *)arg;
+	BufferManager *bufferManager = (BufferManager *)bm->mgmtData;
+	pthread_mutex_lock(&bufferManager->prefetchLatch);
+	while (!bufferManager->prefetcherStop)
+	{
+		PrefetchRequest request;
+		if (bufferManager->prefetchCount == 0)
+		{
+			pthread_cond_wait(&bufferManager->prefetchCond, &bufferManager->prefetchLatch);
+			continue;
+		}
+		request = bufferManager->prefetchQueue[bufferManager->prefetchHead];
+		bufferManager->prefetchHead = (bufferManager->prefetchHead + 1) % BM_PREFETCH_QUEUE;
+		bufferManager->prefetchCount--;
+		bufferManager->prefetchRing = request.ring;
+		bufferManager->prefetchFileId = KEY_FILE_ID(request.startPage);
+		pthread_mutex_unlock(&bufferManager->prefetchLatch);
+		if (request.pages != NULL)
+			prefetchPageList(bm, bufferManager, request.pages, request.count);
+		else
+			prefetchRange(bm, bufferManager, request.ring, request.startPage, request.count);
+		free(request.pages);
+		pthread_mutex_lock(&bufferManager->prefetchLatch);
+		bufferManager->prefetchRing = NULL;
+		bufferManager->prefetchFileId = -1;
+		pthread_cond_broadcast(&bufferManager->prefetchIdle);
+	}
+	pthread_mutex_unlock(&bufferManager->prefetchLatch);
+	return NULL;
+}
+
+/*
+1. This method queues request for the prefetcher, starting the thread on first use
+2. Requests are dropped while BM_PREFETCH_QUEUE of them are waiting, prefetching is only a hint; a dropped warm-up list is freed
+*/
+RC queuePrefetchRequest(BufferManager *bufferManager, BM_BufferPool *const bm, PrefetchRequest *request)
+{
+	RC returnCode = RC_OK;
+	bool queued = false;
+	pthread_mutex_lock(&bufferManager->prefetchLatch);
+	if (!bufferManager->prefetcherRunning)
+	{
+		if (pthread_create(&bufferManager->prefetcher, NULL, runPrefetcher, bm) == 0)
+			bufferManager->prefetcherRunning = true;
+		else
+			returnCode = RC_ERROR;
+	}
+	if (returnCode == RC_OK && bufferManager->prefetchCount < BM_PREFETCH_QUEUE)
+	{
+		bufferManager->prefetchQueue[(bufferManager->prefetchHead + bufferManager->prefetchCount) % BM_PREFETCH_QUEUE] = *request;
+		bufferManager->prefetchCount++;
+		queued = true;
+		pthread_cond_signal(&bufferManager->prefetchCond);
+	}
+	pthread_mutex_unlock(&bufferManager->prefetchLatch);
+	if (!queued)
+		free(request->pages);
+	return returnCode;
+}
+
+/*
+1. This method queues the range startPage .. startPage + count - 1 (keys) for the prefetcher
+*/
+RC queuePrefetch(BufferManager *bufferManager, BM_BufferPool *const bm, BM_ScanRing *const ring, const PageNumber startPage, const int count)
+{
+	PrefetchRequest request;
+	if (count <= 0)
+		return RC_OK;
+	request.startPage = startPage;
+	request.count = count;
+	request.ring = ring;
+	request.pages = NULL;
+	return queuePrefetchRequest(bufferManager, bm, &request);
+}
+
+/*
+1. This method queues the pages of the file fileId listed in its warm-up list for the prefetcher, in page number order
+2. At most maxPages pages are loaded, the lowest page numbers; pages no longer in the file are skipped
+3. A missing or damaged list is ignored, the pool just starts cold
+*/
+void loadWarmUpList(BM_BufferPool *const bm, BufferManager *bufferManager, const int fileId, int maxPages)
+{
+	PrefetchRequest request;
+	WarmUpHeader header;
+	PageNumber *pages = NULL;
+	FILE *file;
+	int numPages = 0;
+	int count = 0;
+	int i;
+
+	if (bufferManager->warmUpFiles[fileId] == NULL || (file = fopen(bufferManager->warmUpFiles[fileId], "rb")) == NULL)
+		return;
+	if (fread(&header, sizeof(WarmUpHeader), 1, file) == 1 && header.magic == BM_WARMUP_MAGIC && header.count > 0 &&
+		(pages = (PageNumber *)malloc(sizeof(PageNumber) * header.count)) != NULL &&
+		fread(pages, sizeof(PageNumber), header.count, file) == (size_t)header.count)
+		numPages = header.count;
+	fclose(file);
+	qsort(pages, numPages, sizeof(PageNumber), comparePageNumbers);
+	for (i = 0; i < numPages && count < maxPages; i++)
+	{
+		if (pages[i] < 0 || (pages[i] >> BM_FILE_ID_SHIFT) != 0 || (count > 0 && pages[i] == KEY_PAGE_NUMBER(pages[count - 1])))
+			continue;
+		pages[count++] = PAGE_KEY(fileId, pages[i]);
+	}
+	if (count == 0)
+	{
+		free(pages);
+		return;
+	}
+	request.startPage = pages[0];
+	request.count = count;
+	request.ring = NULL;
+	request.pages = pages;
+	queuePrefetchRequest(bufferManager, bm, &request);
+}
+
+/*
+1. This method asks the pool to load the pages startPage .. startPage + count - 1 in the background and returns right away
+2. The pages are read on the pool's prefetcher thread into unpinned frames chosen by the replacement strategy; a pinPage of
+a page whose read is in flight waits only for that read, the first pin of a prefetched page counts as its load
+3. At most half of the pool is prefetched by one call, pages past the end of the file are skipped
+*/
+RC prefetchPages(BM_BufferPool *const bm, const PageNumber startPage, const int count)
+{
+	return prefetchFilePages(bm, 0, startPage, count);
+}
+
+/*
+1. This method prefetches like prefetchPages, the pages of the page file fileId
+2. Returns RC_FILE_HANDLE_NOT_INIT if no file has the id
+*/
+RC prefetchFilePages(BM_BufferPool *const bm, const int fileId, const PageNumber startPage, const int count)
+{
+	if (!CheckValidManagementData(bm))
+		return RC_BUFFER_POOL_NOT_INIT;
+	BufferManager *bufferManager = bm->mgmtData;
+	int numPages = (count < bufferManager->numFrames / 2) ? count : bufferManager->numFrames / 2;
+	if (fileId < 0 || fileId >= BM_MAX_PAGE_FILES || bufferManager->files[fileId] == NULL)
+		return RC_FILE_HANDLE_NOT_INIT;
+	if (startPage < 0 || (startPage >> BM_FILE_ID_SHIFT) != 0)
+		return RC_OK;
+	return queuePrefetch(bufferManager, bm, NULL, PAGE_KEY(fileId, startPage), numPages);
+}
+
+/*
+1. This method prefetches like prefetchFilePages, but into the frames of a scan ring and from the ring's file
+2. At most numFrames - 1 pages are loaded by one call, so the ring keeps a slot for the page the scan has pinned
+*/
+RC prefetchRingPages(BM_BufferPool *const bm, BM_ScanRing *const ring, const PageNumber startPage, const int count)
+{
+	if (!CheckValidManagementData(bm))
+		return RC_BUFFER_POOL_NOT_INIT;
+	if (ring == NULL || ring->mgmtData == NULL)
+		return RC_ERROR;
+	if (startPage < 0 || (startPage >> BM_FILE_ID_SHIFT) != 0)
+		return RC_OK;
+	return queuePrefetch((BufferManager *)bm->mgmtData, bm, ring, PAGE_KEY(ring->fileId, startPage),
+						 (count < ring->numFrames - 1) ? count : ring->numFrames - 1);
+}
+
+/*
+1. This method drops the queued prefetches into ring, or of the file fileId, and waits for one the prefetcher is loading
+2. ring is NULL to match by file, fileId -1 to match by ring
+*/
+void dropQueuedPrefetches(BufferManager *bufferManager, BM_ScanRing *const ring, const int fileId)
+{
+	int kept = 0;
+	int i;
+	pthread_mutex_lock(&bufferManager->prefetchLatch);
+	for (i = 0; i < bufferManager->prefetchCount; i++)
+	{
+		PrefetchRequest *request = &bufferManager->prefetchQueue[(bufferManager->prefetchHead + i) % BM_PREFETCH_QUEUE];
+		if ((ring == NULL || request->ring != ring) && (fileId < 0 || KEY_FILE_ID(request->startPage) != fileId))
+			bufferManager->prefetchQueue[(bufferManager->prefetchHead + kept++) % BM_PREFETCH_QUEUE] = *request;
+		else
+			free(request->pages);
+	}
+	bufferManager->prefetchCount = kept;
+	while ((ring != NULL && bufferManager->prefetchRing == ring) || (fileId >= 0 && bufferManager->prefetchFileId == fileId))
+		pthread_cond_wait(&bufferManager->prefetchIdle, &bufferManager->prefetchLatch);
+	pthread_mutex_unlock(&bufferManager->prefetchLatch);
+}
+
+/*
+1. This method sets up a scan ring of numFrames frames for bulk reads from the pool, such as full table scans
+2. Misses of pinPageWithRing load their pages into the ring's frames, which are recycled over and over, so a scan pushes
+only those few frames' pages out of the pool instead of the whole pool; a page someone else pins meanwhile stays in the pool
+3. The ring takes at most half of the pool; returns RC_ERROR if its slots cannot be allocated
+4. The ring reads the pool's own file
+*/
+RC initScanRing(BM_BufferPool *const bm, BM_ScanRing *const ring, const int numFrames)
+{
+	return initFileScanRing(bm, 0, ring, numFrames);
+}
+
+/*
+1. This method sets up a scan ring like initScanRing for the pages of the page file fileId
+2. Returns RC_FILE_HANDLE_NOT_INIT if no file has the id
+*/
+RC initFileScanRing(BM_BufferPool *const bm, const int fileId, BM_ScanRing *const ring, const int numFrames)
+{
+	if (!CheckValidManagementData(bm))
+		return RC_BUFFER_POOL_NOT_INIT;
+	BufferManager *bufferManager = bm->mgmtData;
+	if (fileId < 0 || fileId >= BM_MAX_PAGE_FILES || bufferManager->files[fileId] == NULL)
+		return RC_FILE_HANDLE_NOT_INIT;
+	ScanRing *scanRing = (ScanRing *)malloc(sizeof(ScanRing));
+	int size = (numFrames < bufferManager->numFrames / 2) ? numFrames : bufferManager->numFrames / 2;
+	int i;
+
+	if (size < 1)
+		size = 1;
+	if (scanRing == NULL)
+		return RC_ERROR;
+	scanRing->frames = (BufferFrame **)malloc(sizeof(BufferFrame *) * size);
+	scanRing->pages = (PageNumber *)malloc(sizeof(PageNumber) * size);
+	if (scanRing->frames == NULL || scanRing->pages == NULL)
 	{
-		// frees it then iterates through the frames
-		free(frame->data);
-		frame = frame->nextFrame;
+		free(scanRing->frames);
+		free(scanRing->pages);
+		free(scanRing);
+		return RC_ERROR;
 	}
-	free(frame);
-	CleanBufferPool(bufferManager, bm);
+	for (i = 0; i < size; i++)
+	{
+		scanRing->frames[i] = NULL;
+		scanRing->pages[i] = NO_PAGE;
+	}
+	scanRing->next = 0;
+	ring->numFrames = size;
+	ring->fileId = fileId;
+	ring->mgmtData = scanRing;
 	return RC_OK;
 }
 
-/* Darek Nowak A20497998 + Ramya Krishnan(rkrishnan1@hawk.iit.edu) - A20506653
-// This function will pass trhough a page, check if it's in the buffer, and then mark it dirty so that it can't be removed until it's written back to disk.
-//  1. Searches for given page
-//  2. If found in buffer, marks as dirty
+/*
+1. This method frees a scan ring; its pages stay in the pool and are replaced like any other
+2. Prefetches into the ring still queued are dropped, one the prefetcher is loading is waited for
 */
-RC markDirty(BM_BufferPool *const bm, BM_PageHandle *const page)
+RC shutdownScanRing(BM_BufferPool *const bm, BM_ScanRing *const ring)
 {
-	int flag = 1;
-	// check buffer pool exists
 	if (!CheckValidManagementData(bm))
 		return RC_BUFFER_POOL_NOT_INIT;
-
 	BufferManager *bufferManager = bm->mgmtData;
-	BufferFrame *frame = bufferManager->head;
-	do
-	{
-		// case it exists and is dirty, mark dirty
-		if (frame->pageNumber == page->pageNum)
-		{
-			frame->dirtyFlag = flag;
-			return RC_OK;
-		}
-		// not dirty so iterates through
-		else
-			frame = frame->nextFrame;
+	ScanRing *scanRing = (ScanRing *)ring->mgmtData;
+	int i;
 
-	} while (frame != bufferManager->head);
+	if (scanRing == NULL)
+		return RC_OK;
+	dropQueuedPrefetches(bufferManager, ring, -1);
 
+	// the frames are the pool's again
+	pthread_mutex_lock(&bufferManager->poolLatch);
+	for (i = 0; i < ring->numFrames; i++)
+		if (scanRing->frames[i] != NULL && scanRing->frames[i]->pageNumber == scanRing->pages[i])
+			scanRing->frames[i]->inRing = 0;
+	pthread_mutex_unlock(&bufferManager->poolLatch);
+	free(scanRing->frames);
+	free(scanRing->pages);
+	free(scanRing);
+	ring->mgmtData = NULL;
 	return RC_OK;
 }
 
-/* Darek Nowak A20497998 + Ramya Krishnan(rkrishnan1@hawk.iit.edu) - A20506653
-// 1. Checks to see if page is in the buffer pool
-// 2. If it is, decrement total count of frame used in buffer
+/*
+1. This method does the replacement strategy's bookkeeping for a claimed frame whose page leaves the pool without a new one, the caller holds the pool latch
+2. The frame becomes an empty frame again: CLOCK clears its reference bit, LFU files it under frequency 0, LRU-K forgets its history
+and ARC puts it back on the free list; LRU and FIFO reach it in their ring
 */
-RC unpinPage(BM_BufferPool *const bm, BM_PageHandle *const page)
+void emptyFrame(BM_BufferPool *const bm, BufferManager *bufferManager, BufferFrame *frame)
 {
-	BufferManager *bufferManager = getunpinPageManager(bm);
-	BufferFrame *frame = getunpinPageFrame(bufferManager);
-	int number = bufferManager->head->pageNumber;
-	PageNumber pn = page->pageNum;
-	if (number == pn)
+	if (bm->strategy == RS_CLOCK)
+		frame->refBit = 0;
+	else if (bm->strategy == RS_LFU)
 	{
-		bufferManager->head->count--;
-		return RC_OK;
+		lfuUnlinkFrame(bufferManager, frame);
+		lfuAddEmptyFrame(bufferManager, frame);
 	}
-	frame = frame->nextFrame;
-	int i;
-	// iterates through manager
-	for (i = 0; frame != bufferManager->head; i++)
+	else if (bm->strategy == RS_LRU_K)
+	{
+		memset(frame->history, 0, sizeof(int64_t) * bufferManager->lrukK);
+		frame->lastReference = 0;
+	}
+	else if (bm->strategy == RS_ARC)
+	{
+		arcRemove(frame);
+		arcPush(&bufferManager->arcFree, frame);
+	}
+}
+
+/*
+1. This method removes the page of the file fileId that frame holds from the pool, the page must have been written back
+2. A frame still writing back a page of the file for another page's load is waited for
+3. Returns RC_ERROR if the page is pinned, RC_OK if the frame holds no page of the file (any more)
+*/
+RC dropFramePage(BM_BufferPool *const bm, BufferManager *bufferManager, BufferFrame *frame, const int fileId)
+{
+	PageNumber key;
+	RC returnCode = RC_OK;
+	for (;;)
 	{
-		// decrement total count of frame used in buffer
-		if (frame->pageNumber == page->pageNum)
+		bool writingBack;
+		pthread_mutex_lock(&bufferManager->poolLatch);
+		key = frame->pageNumber;
+		writingBack = (frame->loading && frame->previousPage != NO_PAGE && KEY_FILE_ID(frame->previousPage) == fileId);
+		if (!writingBack && (key == NO_PAGE || KEY_FILE_ID(key) != fileId))
 		{
-			frame->count--;
+			pthread_mutex_unlock(&bufferManager->poolLatch);
 			return RC_OK;
 		}
-		// iterate through
-		frame = frame->nextFrame;
+		if (!writingBack && frame->count != 0)
+		{
+			pthread_mutex_unlock(&bufferManager->poolLatch);
+			return RC_ERROR;
+		}
+		if (!writingBack && claimFrame(bufferManager, frame))
+			break;
+		pthread_mutex_unlock(&bufferManager->poolLatch);
+		// a load, a write-back or a flush of the frame is in flight
+		waitForFrame(frame);
+	}
+	emptyFrame(bm, bufferManager, frame);
+	pthread_mutex_unlock(&bufferManager->poolLatch);
+	// dirtied again since the file was flushed
+	if (clearFrameDirty(bufferManager, frame))
+	{
+		PageTablePartition *partition = pageTablePartition(bufferManager, key);
+		returnCode = writeBlock(KEY_PAGE_NUMBER(key), keyFile(bufferManager, key), frame->data);
+		if (returnCode == RC_OK)
+		{
+			bufferManager->numWrite++;
+			bufferManager->numFlushWrites++;
+		}
+		pthread_mutex_lock(&partition->latch);
+		pageTableRemove(&partition->table, key, frame);
+		pthread_mutex_unlock(&partition->latch);
 	}
+	frame->loading = 0;
+	frame->count--;
+	pthread_rwlock_unlock(&frame->latch);
+	return returnCode;
+}
 
-	return RC_OK;
+/*
+1. This method forgets what the strategy remembers of the pages of the file fileId that left the pool: ARC ghosts and LRU-K retained histories
+2. A file attached later under the same id starts without them; the caller holds the pool latch
+*/
+void forgetFileHistory(BM_BufferPool *const bm, BufferManager *bufferManager, const int fileId)
+{
+	BufferFrame *ghost;
+	BufferFrame *previous;
+	int i;
+	if (bm->strategy == RS_ARC)
+	{
+		for (ghost = bufferManager->arcB1.last; ghost != NULL; ghost = previous)
+		{
+			previous = ghost->arcPrev;
+			if (KEY_FILE_ID(ghost->pageNumber) == fileId)
+				arcForgetGhost(bufferManager, ghost);
+		}
+		for (ghost = bufferManager->arcB2.last; ghost != NULL; ghost = previous)
+		{
+			previous = ghost->arcPrev;
+			if (KEY_FILE_ID(ghost->pageNumber) == fileId)
+				arcForgetGhost(bufferManager, ghost);
+		}
+	}
+	else if (bm->strategy == RS_LRU_K)
+	{
+		for (i = 0; i < bufferManager->lrukRetainedSize; i++)
+			if (bufferManager->lrukRetained[i].pageNumber != NO_PAGE && KEY_FILE_ID(bufferManager->lrukRetained[i].pageNumber) == fileId)
+				lrukForgetRetained(bufferManager, bufferManager->lrukRetained[i].pageNumber);
+	}
 }
 
-/* Darek Nowak A20497998 + Ramya Krishnan(rkrishnan1@hawk.iit.edu) - A20506653
-// 1. Checks if the page exists
-// 2. If it does, it will check to see if it is dirty
-// 3. If it is dirty, writes to disk and increments writeIO count
+/*
+1. This method opens the page file pageFileName and lets it share the pool's frames with the pool's other files
+2. fileId returns the id its pages are pinned under (pinFilePage, prefetchFilePages, initFileScanRing); the file gets the
+pool's I/O backend and async queue depth
+3. Returns RC_INVALID_PAGE_SIZE if the file's pages are larger than the pool's frames, RC_ERROR if BM_MAX_PAGE_FILES files are open
 */
-RC forcePage(BM_BufferPool *const bm, BM_PageHandle *const page)
+RC attachPageFile(BM_BufferPool *const bm, const char *const pageFileName, int *fileId)
 {
-	BufferManager *bufferManager = getunpinPageManager(bm);
-	BufferFrame *frame = getunpinPageFrame(bufferManager);
+	if (!CheckValidManagementData(bm))
+		return RC_BUFFER_POOL_NOT_INIT;
+	BufferManager *bufferManager = bm->mgmtData;
+	SM_FileHandle *fileHandle = (SM_FileHandle *)malloc(sizeof(SM_FileHandle));
+	RC returnCode;
+	int i;
 
-	bufferManager->smFileHandle = (SM_FileHandle *)malloc(sizeof(SM_FileHandle));
-	RC openpageReturnCode = openPageFile((char *)(bm->pageFile), bufferManager->smFileHandle);
-	// checks if existing based on return code
-	if (openpageReturnCode == RC_OK)
+	if (fileHandle == NULL)
+		return RC_ERROR;
+	returnCode = openPageFileWithMode((char *)pageFileName, fileHandle, bufferManager->ioMode);
+	if (returnCode != RC_OK)
 	{
-		do
-		{ // dirty checking and page number within frame check
-			if (frame->dirtyFlag == 1 && frame->pageNumber == page->pageNum)
-			{
-				RC writeBlockReturnCode = writeBlock(frame->pageNumber, bufferManager->smFileHandle, frame->data);
-				// case we can write, then write to disk and continue
-				if (writeBlockReturnCode == RC_OK)
-				{
-					frame->dirtyFlag = 0;
-					bufferManager->numWrite++;
-				}
-				else
-				{
-					closePageFile(bufferManager->smFileHandle);
-					return writeBlockReturnCode;
-				}
-			}
-			frame = frame->nextFrame;
-		} while (frame != bufferManager->head);
+		free(fileHandle);
+		return returnCode;
+	}
+	if (fileHandle->pageSize > bufferManager->pageSize)
+	{
+		closePageFile(fileHandle);
+		free(fileHandle);
+		return RC_INVALID_PAGE_SIZE;
+	}
+	initAsyncIO(fileHandle, bufferManager->ioQueueDepth);
+	pthread_mutex_lock(&bufferManager->filesLatch);
+	for (i = 1; i < BM_MAX_PAGE_FILES && bufferManager->files[i] != NULL; i++)
+		;
+	if (i < BM_MAX_PAGE_FILES)
+		bufferManager->files[i] = fileHandle;
+	pthread_mutex_unlock(&bufferManager->filesLatch);
+	if (i == BM_MAX_PAGE_FILES)
+	{
+		closePageFile(fileHandle);
+		free(fileHandle);
+		return RC_ERROR;
+	}
+	*fileId = i;
+	// the pool is in use, the list gets at most half of it like any prefetch
+	if (bufferManager->warmUp)
+	{
+		bufferManager->warmUpFiles[i] = warmUpFileName(pageFileName);
+		loadWarmUpList(bm, bufferManager, i, bufferManager->numFrames / 2);
 	}
-	else
-		return openpageReturnCode;
-	closePageFile(bufferManager->smFileHandle);
 	return RC_OK;
 }
 
 /*
-1. This method gets the strategy, page number and required
-parameters to check if the page exists
-2. Returns RC_OK if page exists
+1. This method writes back and removes the pages of the file fileId from the pool, syncs and closes the file, its id is free again
+2. Queued prefetches of the file are dropped; none of its pages may be pinned, RC_ERROR is returned then and the file stays attached
+3. The pool's own file (id 0) stays until shutdownBufferPool
 */
-RC CheckIfPageExists(int algo, const PageNumber pageNum,
-					 BufferManager *bufferManager, BM_PageHandle *const page)
+RC detachPageFile(BM_BufferPool *const bm, const int fileId)
 {
-	int value = 0;
-	BufferFrame *frame = bufferManager->head;
-	do
-	{ // case the manager is not at the head and frame page number isnt the page number
-		if (frame->pageNumber != pageNum)
-			// iterate through
-			frame = frame->nextFrame;
-		else
-		{ // if not, then re-assign values
-			page->pageNum = pageNum;
-			page->data = frame->data;
-
-			frame->pageNumber = pageNum;
-			frame->count++;
-			// required and mentioned LRU
-			if (algo == RS_LRU)
-			{
-				bufferManager->tail = bufferManager->head->nextFrame;
-				bufferManager->head = frame;
-			}
-			value = 1;
-			return RC_OK;
-		}
-	} while (frame != bufferManager->head);
-	// error display for non-existing
-	if (value == 0)
-		return RC_IM_KEY_NOT_FOUND;
-	return RC_OK;
+	if (!CheckValidManagementData(bm))
+		return RC_BUFFER_POOL_NOT_INIT;
+	BufferManager *bufferManager = bm->mgmtData;
+	SM_FileHandle *fileHandle;
+	RC returnCode;
+	int i;
+
+	if (fileId <= 0 || fileId >= BM_MAX_PAGE_FILES || bufferManager->files[fileId] == NULL)
+		return RC_FILE_HANDLE_NOT_INIT;
+	dropQueuedPrefetches(bufferManager, NULL, fileId);
+	returnCode = flushDirtyFrames(bufferManager, bufferManager->numFrames, fileId);
+	if (returnCode == RC_OK && bufferManager->warmUpFiles[fileId] != NULL)
+		saveWarmUpList(bufferManager, fileId);
+	pthread_rwlock_rdlock(&bufferManager->framesLatch);
+	for (i = 0; i < bufferManager->numFrames && returnCode == RC_OK; i++)
+		returnCode = dropFramePage(bm, bufferManager, bufferManager->frames[i], fileId);
+	pthread_rwlock_unlock(&bufferManager->framesLatch);
+	if (returnCode != RC_OK)
+		return returnCode;
+	pthread_mutex_lock(&bufferManager->poolLatch);
+	forgetFileHistory(bm, bufferManager, fileId);
+	pthread_mutex_unlock(&bufferManager->poolLatch);
+	pthread_mutex_lock(&bufferManager->filesLatch);
+	fileHandle = bufferManager->files[fileId];
+	bufferManager->files[fileId] = NULL;
+	pthread_mutex_unlock(&bufferManager->filesLatch);
+	free(bufferManager->warmUpFiles[fileId]);
+	bufferManager->warmUpFiles[fileId] = NULL;
+	returnCode = forceFileHeader(fileHandle);
+	if (returnCode == RC_OK)
+		returnCode = syncPageFile(fileHandle);
+	if (closePageFile(fileHandle) != RC_OK && returnCode == RC_OK)
+		returnCode = RC_ERROR;
+	free(fileHandle);
+	return returnCode;
 }
 
 /*
-1. This method is used to check if the buffer pool is empty*/
-void CheckIfBufferPoolIsEmpty(const PageNumber pageNumber,
-							  BM_BufferPool *const bufferPool)
+1. This method links an empty frame into the pool's ring before its head and appends it to the frame table, which has room for it,
+the caller holds the pool latch
+2. LFU files it under frequency 0 and ARC puts it on the free list, so it is used before any page is replaced
+*/
+void addPoolFrame(BM_BufferPool *const bm, BufferManager *bufferManager, BufferFrame *frame)
 {
-	BufferManager *bufferManager = getunpinPageManager(bufferPool);
-	BufferFrame *frame = getunpinPageFrame(bufferManager);
-	int np = bufferPool->numPages;
-	int c = bufferManager->count;
-	if (np > c)
+	BufferFrame *head = bufferManager->head;
+	if (head == NULL)
 	{
-		frame = bufferManager->head;
-		frame->pageNumber = pageNumber;
-		BufferFrame *nxt = frame->nextFrame;
-		BufferFrame *head = bufferManager->head;
-		if (nxt != head)
-		{
-			bufferManager->head = nxt;
-		}
-		frame->count = frame->count + 1;
-		bufferManager->count = bufferManager->count + 1;
+		frame->nextFrame = frame;
+		frame->prevFrame = frame;
+		bufferManager->head = frame;
+		bufferManager->tail = frame;
+		bufferManager->start = frame;
+		bufferManager->clockHand = frame;
+	}
+	else
+	{
+		frame->nextFrame = head;
+		frame->prevFrame = head->prevFrame;
+		head->prevFrame->nextFrame = frame;
+		head->prevFrame = frame;
 	}
+	if (bm->strategy == RS_LFU)
+		lfuAddEmptyFrame(bufferManager, frame);
+	else if (bm->strategy == RS_ARC)
+		arcPush(&bufferManager->arcFree, frame);
+	bufferManager->frames[bufferManager->numFrames++] = frame;
 }
 
 /*
-This method is used to close the page file and return code
+1. This method takes a claimed frame without a page out of the pool's ring, the replacement strategy and the frame table,
+the caller holds the pool latch
+2. The ring's anchors (head, tail, start and the clock hand) move on to the next frame if they point at it
 */
-RC CheckReturnCode(SM_FileHandle sm_fileHandle, RC returnCode)
+void removePoolFrame(BM_BufferPool *const bm, BufferManager *bufferManager, BufferFrame *frame)
 {
-	closePageFile(&sm_fileHandle);
-	return returnCode;
+	int i;
+	if (bm->strategy == RS_LFU)
+		lfuUnlinkFrame(bufferManager, frame);
+	else if (bm->strategy == RS_ARC)
+		arcRemove(frame);
+	if (bufferManager->head == frame)
+		bufferManager->head = frame->nextFrame;
+	if (bufferManager->tail == frame)
+		bufferManager->tail = frame->nextFrame;
+	if (bufferManager->start == frame)
+		bufferManager->start = frame->nextFrame;
+	if (bufferManager->clockHand == frame)
+		bufferManager->clockHand = frame->nextFrame;
+	frame->prevFrame->nextFrame = frame->nextFrame;
+	frame->nextFrame->prevFrame = frame->prevFrame;
+	for (i = 0; bufferManager->frames[i] != frame; i++)
+		;
+	memmove(&bufferManager->frames[i], &bufferManager->frames[i + 1], sizeof(BufferFrame *) * (bufferManager->numFrames - i - 1));
+	bufferManager->numFrames--;
 }
 
 /*
-1.This method is used to pin the last recently used frame from the buffer frame
-2. Returns RC_OK if the write block and read block are executed and succeeded
+1. This method brings the ARC lists of a pool that shrank to c frames back within ARC's bounds, the caller holds the pool latch
+2. The target size of T1 is at most c, T1 and B1 hold at most c pages and all four lists at most 2c; the oldest ghosts are forgotten
 */
-RC LRU(SM_FileHandle sm_FileHandle, BM_PageHandle *const page, const PageNumber pageNumber,
-	   BufferFrame *frame, BM_BufferPool *const bm, BufferManager *bufferManager)
+void arcFitPoolSize(BufferManager *bufferManager, int c)
 {
-	if (bm->numPages <= bufferManager->count)
-	{
-		frame = bufferManager->tail;
-		do
-		{
-			if (frame->count != 0)
-				frame = frame->nextFrame;
-			else
-			{
-				if (frame->dirtyFlag != 0)
-				{
-					int pn = frame->pageNumber;
-					ensureCapacity(pn, &sm_FileHandle);
-					RC writeBlockReturnCode = writeBlock(pn, &sm_FileHandle, frame->data);
-					if (writeBlockReturnCode == RC_OK)
-						bufferManager->numWrite++;
-					else
-						return CheckReturnCode(sm_FileHandle, writeBlockReturnCode);
-				}
-
-				if (bufferManager->tail == bufferManager->head)
-				{
-					PageNumber pnu = pageNumber;
-					frame = frame->nextFrame;
-					frame->pageNumber = pnu;
-					frame->count++;
-					bufferManager->tail = frame;
-					bufferManager->head = bufferManager->tail;
-					bufferManager->tail = frame->prevFrame;
-					break;
-				}
-				else
-				{
-					PageNumber pnu = pageNumber;
-					frame->pageNumber = pnu;
-					frame->count++;
-					bufferManager->tail = frame->nextFrame;
-					break;
-				}
-			}
-		} while (frame != bufferManager->tail);
-	}
-	else
-		CheckIfBufferPoolIsEmpty(pageNumber, bm);
-	ensureCapacity((pageNumber + 1), &sm_FileHandle);
-	RC readBlockReturnCode = readBlock(pageNumber, &sm_FileHandle, frame->data);
-	if (readBlockReturnCode == RC_OK)
-		bufferManager->numRead++;
-	else
-		return readBlockReturnCode;
-	page->pageNum = pageNumber;
-	page->data = frame->data;
-	closePageFile(&sm_FileHandle);
-	return RC_OK;
+	if (bufferManager->arcTarget > c)
+		bufferManager->arcTarget = c;
+	while (bufferManager->arcB1.size > 0 && bufferManager->arcT1.size + bufferManager->arcB1.size > c)
+		arcForgetGhost(bufferManager, bufferManager->arcB1.last);
+	while (bufferManager->arcB2.size > 0 &&
+		   bufferManager->arcT1.size + bufferManager->arcT2.size + bufferManager->arcB1.size + bufferManager->arcB2.size > 2 * c)
+		arcForgetGhost(bufferManager, bufferManager->arcB2.last);
 }
 
 /*
-1.This method is used to pin the FIFO frame from the buffer frame
-2. Returns RC_OK if the write block and read block are executed and succeeded
+1. This method adds empty frames to the pool until it has numPages, the caller holds the frames latch exclusively
+2. Frames an earlier shrink took out are used first, the rest come from a new segment with the LFU buckets, ARC ghosts
+and LRU-K history its frames need
+3. Returns RC_ERROR if the memory cannot be allocated, the pool keeps its size then
 */
-RC FIFO(SM_FileHandle sm_FileHandle, BM_PageHandle *const page, const PageNumber pageNumber,
-		BufferFrame *bufferFrame, BM_BufferPool *const bm, BufferManager *mgmt)
+RC growFramePool(BM_BufferPool *const bm, BufferManager *bufferManager, const int numPages)
 {
-	if (bm->numPages <= mgmt->count)
+	BufferFrame **frames = NULL;
+	FrameSegment *segment = NULL;
+	BufferFrame *frame;
+	int numSpare = 0;
+	int numNew;
+	int i;
+
+	for (frame = bufferManager->spareFrames; frame != NULL && bufferManager->numFrames + numSpare < numPages; frame = frame->nextFrame)
+		numSpare++;
+	numNew = numPages - bufferManager->numFrames - numSpare;
+	if (numPages > bufferManager->frameCapacity && (frames = (BufferFrame **)malloc(sizeof(BufferFrame *) * numPages)) == NULL)
+		return RC_ERROR;
+	if (numNew > 0)
 	{
-		bufferFrame = mgmt->tail;
-		do
+		segment = createFrameSegment(bufferManager, numNew);
+		if (segment != NULL && bm->strategy == RS_LFU)
+			segment->lfuBuckets = (LFUBucket *)malloc(sizeof(LFUBucket) * numNew);
+		else if (segment != NULL && bm->strategy == RS_ARC)
+			segment->arcGhosts = (BufferFrame *)calloc(numNew, sizeof(BufferFrame));
+		else if (segment != NULL && bm->strategy == RS_LRU_K)
+			segment->lrukHistory = (int64_t *)calloc((size_t)numNew * bufferManager->lrukK, sizeof(int64_t));
+		if (segment == NULL || (bm->strategy == RS_LFU && segment->lfuBuckets == NULL) ||
+			(bm->strategy == RS_ARC && segment->arcGhosts == NULL) || (bm->strategy == RS_LRU_K && segment->lrukHistory == NULL))
 		{
-			if (bufferFrame->count != 0)
-				bufferFrame = bufferFrame->nextFrame;
-			else
-			{
-				if (bufferFrame->dirtyFlag != 0)
-				{
-					int pn = bufferFrame->pageNumber;
-					ensureCapacity(pn, &sm_FileHandle);
-					RC writeBlockReturnCode = writeBlock(pn, &sm_FileHandle, bufferFrame->data);
-					if (writeBlockReturnCode == RC_OK)
-						mgmt->numWrite++;
-					else
-						return CheckReturnCode(sm_FileHandle, writeBlockReturnCode);
-				}
+			if (segment != NULL)
+				freeFrameSegment(segment);
+			free(frames);
+			return RC_ERROR;
+		}
+		for (i = 0; i < numNew; i++)
+		{
+			frame = &segment->frames[i];
+			frame->data = segment->arena + (size_t)i * bufferManager->pageSize;
+			frame->pageNumber = NO_PAGE;
+			frame->previousPage = NO_PAGE;
+			frame->ioResult = RC_OK;
+			if (segment->lrukHistory != NULL)
+				frame->history = segment->lrukHistory + (size_t)i * bufferManager->lrukK;
+			pthread_rwlock_init(&frame->latch, NULL);
+		}
+	}
 
-				mgmt->tail = bufferFrame->nextFrame;
-				bufferFrame->pageNumber = pageNumber;
-				mgmt->head = bufferFrame;
-				bufferFrame->count++;
-				break;
+	pthread_mutex_lock(&bufferManager->poolLatch);
+	if (frames != NULL)
+	{
+		memcpy(frames, bufferManager->frames, sizeof(BufferFrame *) * bufferManager->numFrames);
+		free(bufferManager->frames);
+		bufferManager->frames = frames;
+		bufferManager->frameCapacity = numPages;
+	}
+	for (i = 0; i < numSpare; i++)
+	{
+		frame = bufferManager->spareFrames;
+		bufferManager->spareFrames = frame->nextFrame;
+		addPoolFrame(bm, bufferManager, frame);
+	}
+	if (segment != NULL)
+	{
+		segment->next = bufferManager->segments;
+		bufferManager->segments = segment;
+		for (i = 0; i < numNew; i++)
+		{
+			if (segment->lfuBuckets != NULL)
+			{
+				segment->lfuBuckets[i].nextBucket = bufferManager->lfuFreeBuckets;
+				bufferManager->lfuFreeBuckets = &segment->lfuBuckets[i];
 			}
-
-		} while (bufferFrame != mgmt->head);
+			if (segment->arcGhosts != NULL)
+			{
+				segment->arcGhosts[i].arcNext = bufferManager->arcFreeGhosts;
+				bufferManager->arcFreeGhosts = &segment->arcGhosts[i];
+			}
+			addPoolFrame(bm, bufferManager, &segment->frames[i]);
+		}
 	}
-
-	else
-		CheckIfBufferPoolIsEmpty(pageNumber, bm);
-	ensureCapacity((pageNumber + 1), &sm_FileHandle);
-	RC readBlockReturnCode = readBlock(pageNumber, &sm_FileHandle, bufferFrame->data);
-	if (readBlockReturnCode == RC_OK)
-		mgmt->numRead++;
-	else
-		return CheckReturnCode(sm_FileHandle, readBlockReturnCode);
-	page->pageNum = pageNumber;
-	page->data = bufferFrame->data;
-	closePageFile(&sm_FileHandle);
+	pthread_mutex_unlock(&bufferManager->poolLatch);
 	return RC_OK;
 }
 
 /*
-1.This method is used to check the replacement strategy
-2. Pins LRU, FIFO based on the replacement strategy algorithm
-3. Returns RC_OK if the LRU and FIFO are executed and succeeded
+1. This method takes frames out of the pool until it has numPages, the caller holds the frames latch exclusively
+2. The replacement strategy picks them like the victims of misses, pinned frames stay and frames being prefetched are waited for;
+dirty pages are written back before they leave the pool
+3. The frames' memory goes back to the system (MADV_DONTNEED), the descriptors are kept for a later grow
+4. Returns RC_NO_FREE_BUFFER_FRAME if too many pages are pinned to get down to numPages, the pool is as small as it got then;
+a write-back that fails leaves its page in the pool, in a frame that stays, and its error is returned
 */
-RC CheckReplacementStrategy(BM_PageHandle *const page, BufferManager *bufferManager, const PageNumber pageNum,
-							ReplacementStrategy strategy, BufferFrame *frame, SM_FileHandle sm_FileHandle, BM_BufferPool *const bufferPool)
+RC shrinkFramePool(BM_BufferPool *const bm, BufferManager *bufferManager, const int numPages)
 {
-	RC IsPageExistsReturnCode;
-	if (bufferPool->strategy == RS_LRU)
+	BufferFrame **victims = (BufferFrame **)malloc(sizeof(BufferFrame *) * (bufferManager->numFrames - numPages));
+	int numVictims = 0;
+	RC returnCode = RC_OK;
+	int i;
+
+	if (victims == NULL)
+		return RC_ERROR;
+	pthread_mutex_lock(&bufferManager->poolLatch);
+	while (bufferManager->numFrames > numPages)
 	{
-		IsPageExistsReturnCode = CheckIfPageExists(RS_LRU, pageNum, bufferManager, page);
-		if (IsPageExistsReturnCode == RC_OK)
-			return RC_OK;
-		else
-			LRU(sm_FileHandle, page, pageNum, frame, bufferPool, bufferManager);
+		BufferFrame *transit = NULL;
+		BufferFrame *frame = pickFrame(bm, bufferManager, NO_PAGE);
+		if (frame != NULL)
+		{
+			emptyFrame(bm, bufferManager, frame);
+			removePoolFrame(bm, bufferManager, frame);
+			victims[numVictims++] = frame;
+			continue;
+		}
+		// the only frames not pinned may be loading prefetched pages
+		for (i = 0; i < bufferManager->numFrames && transit == NULL; i++)
+			if (bufferManager->frames[i]->loading && bufferManager->frames[i]->prefetched)
+				transit = bufferManager->frames[i];
+		if (transit == NULL)
+		{
+			returnCode = RC_NO_FREE_BUFFER_FRAME;
+			break;
+		}
+		pthread_mutex_unlock(&bufferManager->poolLatch);
+		waitForFrame(transit);
+		pthread_mutex_lock(&bufferManager->poolLatch);
 	}
-	else if (bufferPool->strategy == RS_FIFO)
+	pthread_mutex_unlock(&bufferManager->poolLatch);
+
+	for (i = 0; i < numVictims; i++)
 	{
-		IsPageExistsReturnCode = CheckIfPageExists(RS_FIFO, pageNum, bufferManager, page);
-		if (IsPageExistsReturnCode == RC_OK)
-			return RC_OK;
+		BufferFrame *frame = victims[i];
+		PageNumber oldPage = frame->previousPage;
+		bool wasDirty = (clearFrameDirty(bufferManager, frame) && oldPage != NO_PAGE);
+		RC writeReturnCode = RC_OK;
+		countEviction(bufferManager, oldPage, wasDirty);
+		// a dirty page stays listed under the frame until it is on disk, pins of it wait for the frame meanwhile
+		if (wasDirty)
+		{
+			PageTablePartition *partition = pageTablePartition(bufferManager, oldPage);
+			writeReturnCode = writeBlock(KEY_PAGE_NUMBER(oldPage), keyFile(bufferManager, oldPage), frame->data);
+			if (writeReturnCode == RC_OK)
+			{
+				bufferManager->numWrite++;
+				bufferManager->numEvictionWrites++;
+			}
+			pthread_mutex_lock(&partition->latch);
+			if (writeReturnCode == RC_OK)
+				pageTableRemove(&partition->table, oldPage, frame);
+			else
+			{
+				markFrameDirty(bufferManager, frame);
+				frame->pageNumber = oldPage;
+			}
+			pthread_mutex_unlock(&partition->latch);
+		}
+		if (writeReturnCode == RC_OK)
+			madvise(frame->data, bufferManager->pageSize, MADV_DONTNEED);
+		pthread_mutex_lock(&bufferManager->poolLatch);
+		if (writeReturnCode == RC_OK)
+		{
+			frame->nextFrame = bufferManager->spareFrames;
+			bufferManager->spareFrames = frame;
+		}
 		else
-			FIFO(sm_FileHandle, page, pageNum, frame, bufferPool, bufferManager);
-	}
-	else if (bufferPool->strategy == RS_CLOCK)
-	{
-		IsPageExistsReturnCode = CheckIfPageExists(RS_CLOCK, pageNum, bufferManager, page);
-		if (IsPageExistsReturnCode == RC_OK)
-			return RC_OK;
-		// else
-		// 	pinPageCLOCK(bufferPool, page, pageNum);
+		{
+			returnCode = writeReturnCode;
+			addPoolFrame(bm, bufferManager, frame);
+		}
+		pthread_mutex_unlock(&bufferManager->poolLatch);
+		frame->loading = 0;
+		frame->count--;
+		pthread_rwlock_unlock(&frame->latch);
 	}
-	return RC_OK;
+	free(victims);
+	return returnCode;
 }
 
-/* Darek Nowak A20497998 + Ramya Krishnan(rkrishnan1@hawk.iit.edu) - A20506653
-// 1. Passes data through CheckReplacementStrategy() in order to figure out which strategy it'll pin(LRU or FIFO)
+/*
+1. This method changes the number of frames of the pool to numPages while the pool is in use; pins, prefetches and the
+flusher go on meanwhile, walks of the frame table (flushes, detachPageFile, the statistics) wait for the resize
+2. Growing adds empty frames. Shrinking evicts unpinned pages picked by the replacement strategy, writing dirty ones back first,
+and takes their frames out; pinned pages stay in their frames, so page handles stay valid
+3. Returns RC_ERROR for numPages below 1 or if the memory for new frames cannot be allocated,
+RC_NO_FREE_BUFFER_FRAME if too many pages are pinned to shrink that far, the pool keeps the frames it could not free then
 */
-RC pinPage(BM_BufferPool *const bm, BM_PageHandle *const page, const PageNumber pageNum)
+RC resizeBufferPool(BM_BufferPool *const bm, const int numPages)
 {
-	// Choose the appropriate Page Replacement Strategy
-	// We have implemented FIFO, LRU and CLOCK strategy
-
 	if (!CheckValidManagementData(bm))
-		return RC_BUFFER_POOL_EXIST;
+		return RC_BUFFER_POOL_NOT_INIT;
+	BufferManager *bufferManager = bm->mgmtData;
+	RC returnCode = RC_OK;
+	int i;
 
-	RC IsPageExistsReturnCode;
+	if (numPages < 1)
+		return RC_ERROR;
+	// one resize at a time
+	pthread_rwlock_wrlock(&bufferManager->framesLatch);
+	if (numPages > bufferManager->numFrames)
+		returnCode = growFramePool(bm, bufferManager, numPages);
+	else if (numPages < bufferManager->numFrames)
+		returnCode = shrinkFramePool(bm, bufferManager, numPages);
+	pthread_mutex_lock(&bufferManager->poolLatch);
+	if (bm->strategy == RS_ARC)
+		arcFitPoolSize(bufferManager, bufferManager->numFrames);
+	// LRU and FIFO fill empty frames first while fewer frames than the pool has hold a page
+	bufferManager->count = 0;
+	for (i = 0; i < bufferManager->numFrames; i++)
+		if (bufferManager->frames[i]->pageNumber != NO_PAGE)
+			bufferManager->count++;
+	bm->numPages = bufferManager->numFrames;
+	setDirtyThresholds(bufferManager);
+	pthread_mutex_unlock(&bufferManager->poolLatch);
+	pthread_rwlock_unlock(&bufferManager->framesLatch);
+	return returnCode;
+}
 
-	SM_FileHandle sm_FileHandle;
-	BufferManager *bufferManager = bm->mgmtData;
-	BufferFrame *frame = bufferManager->head;
+/*
+1. This method deletes the warm-up list kept for the page file pageFileName, for use when the page file is destroyed
+2. Returns RC_FILE_NOT_FOUND if the file has no list
+*/
+RC destroyWarmUpList(const char *const pageFileName)
+{
+	char *name = warmUpFileName(pageFileName);
+	RC returnCode = RC_FILE_NOT_FOUND;
+	if (name == NULL)
+		return RC_ERROR;
+	if (remove(name) == 0)
+		returnCode = RC_OK;
+	free(name);
+	return returnCode;
+}
 
-	RC openPageReturnCode = openPageFile((char *)bm->pageFile, &sm_FileHandle);
-	if (openPageReturnCode == RC_OK)
-	{
-		CheckReplacementStrategy(page, bufferManager, pageNum, bm->strategy, frame, sm_FileHandle, bm);
-	}
-	return RC_OK;
+/*
+1. This method returns the page file handle opened by the buffer pool
+2. Returns NULL if the pool is not initialized or was initialized without a page file
+*/
+SM_FileHandle *getPoolFileHandle(BM_BufferPool *const bm)
+{
+	return getPageFileHandle(bm, 0);
+}
+
+/*
+1. This method returns the handle of the page file fileId of the pool (header metadata, page count)
+2. Returns NULL if the pool is not initialized or no file has the id
+*/
+SM_FileHandle *getPageFileHandle(BM_BufferPool *const bm, const int fileId)
+{
+	if (!CheckValidManagementData(bm) || fileId < 0 || fileId >= BM_MAX_PAGE_FILES)
+		return NULL;
+	return ((BufferManager *)bm->mgmtData)->files[fileId];
 }
 
 /*
@@ -649,19 +3605,23 @@ Ramya Krishnan(rkrishnan1@hawk.iit.edu) - A20506653
 */
 PageNumber *getFrameContents(BM_BufferPool *const bm)
 {
+	BufferManager *bufferManager = (BufferManager *)bm->mgmtData;
+	// a resize changes the frames and their number
+	pthread_rwlock_rdlock(&bufferManager->framesLatch);
 	int noOfPages = GetPageCount(bm);
 
 	PageNumber *frameContent = getPNForFrameContent(bm, noOfPages);
-	BufferFrame *allFrames = ((BufferManager *)bm->mgmtData)->start;
+	BufferFrame **allFrames = bufferManager->frames;
 	if (frameContent != NULL)
 	{
 		int i;
 		for (i = 0; i < noOfPages; i++)
 		{
-			allFrames = allFrames->nextFrame;
-			frameContent[i] = allFrames->pageNumber;
+			PageNumber key = allFrames[i]->pageNumber;
+			frameContent[i] = (key == NO_PAGE) ? NO_PAGE : KEY_PAGE_NUMBER(key);
 		}
 	}
+	pthread_rwlock_unlock(&bufferManager->framesLatch);
 	return frameContent;
 }
 
@@ -673,21 +3633,21 @@ Ramya Krishnan(rkrishnan1@hawk.iit.edu) - A20506653
 */
 bool *getDirtyFlags(BM_BufferPool *const bm)
 {
+	BufferManager *bufferManager = (BufferManager *)bm->mgmtData;
+	pthread_rwlock_rdlock(&bufferManager->framesLatch);
 	int page_count = GetPageCount(bm);
-	BufferFrame *currentFrame = ((BufferManager *)bm->mgmtData)->start;
+	BufferFrame **allFrames = bufferManager->frames;
 
 	bool *dirtyFlag = (bool *)malloc(sizeof(bool) * page_count);
 	// case exists dirtyflag
 	if (dirtyFlag != NULL)
 	{
 		int i;
+		// iterates through and displays which are dirty
 		for (i = 0; i < page_count; i++)
-		{
-			// iterates through and displays which are dirty
-			dirtyFlag[i] = currentFrame->dirtyFlag;
-			currentFrame = currentFrame->nextFrame;
-		}
+			dirtyFlag[i] = allFrames[i]->dirtyFlag;
 	}
+	pthread_rwlock_unlock(&bufferManager->framesLatch);
 	return dirtyFlag;
 }
 
@@ -699,9 +3659,11 @@ Ramya Krishnan(rkrishnan1@hawk.iit.edu) - A20506653
 */
 int *getFixCounts(BM_BufferPool *const bm)
 {
+	BufferManager *bufferManager = (BufferManager *)bm->mgmtData;
+	pthread_rwlock_rdlock(&bufferManager->framesLatch);
 	int page_count = GetPageCount(bm);
 
-	BufferFrame *currentFrame = ((BufferManager *)bm->mgmtData)->start;
+	BufferFrame **allFrames = bufferManager->frames;
 
 	int *fixCountResult = (int *)malloc(sizeof(int) * page_count);
 
@@ -709,14 +3671,116 @@ int *getFixCounts(BM_BufferPool *const bm)
 	{
 		int i;
 		for (i = 0; i < page_count; i++)
-		{
-			fixCountResult[i] = currentFrame->count;
-			currentFrame = currentFrame->nextFrame;
-		}
+			fixCountResult[i] = allFrames[i]->count;
 	}
+	pthread_rwlock_unlock(&bufferManager->framesLatch);
 	return fixCountResult;
 }
 
+/*
+1. This method takes the page numbers, dirty flags and fix counts of all frames under one hold of the frames latch
+2. The arrays have one entry per frame of that moment, a resize running alongside cannot make them disagree
+3. Returns the number of frames, or -1 if the pool is not initialized or the arrays could not be allocated
+*/
+int getPoolContents(BM_BufferPool *const bm, PageNumber **frameContents, bool **dirtyFlags, int **fixCounts)
+{
+	if (!CheckValidManagementData(bm))
+		return -1;
+	BufferManager *bufferManager = (BufferManager *)bm->mgmtData;
+	int i, numFrames;
+	pthread_rwlock_rdlock(&bufferManager->framesLatch);
+	numFrames = bufferManager->numFrames;
+	*frameContents = (PageNumber *)malloc(sizeof(PageNumber) * numFrames);
+	*dirtyFlags = (bool *)malloc(sizeof(bool) * numFrames);
+	*fixCounts = (int *)malloc(sizeof(int) * numFrames);
+	if (*frameContents == NULL || *dirtyFlags == NULL || *fixCounts == NULL)
+	{
+		pthread_rwlock_unlock(&bufferManager->framesLatch);
+		free(*frameContents);
+		free(*dirtyFlags);
+		free(*fixCounts);
+		return -1;
+	}
+	for (i = 0; i < numFrames; i++)
+	{
+		BufferFrame *frame = bufferManager->frames[i];
+		(*frameContents)[i] = (frame->pageNumber == NO_PAGE) ? NO_PAGE : KEY_PAGE_NUMBER(frame->pageNumber);
+		(*dirtyFlags)[i] = frame->dirtyFlag;
+		(*fixCounts)[i] = frame->count;
+	}
+	pthread_rwlock_unlock(&bufferManager->framesLatch);
+	return numFrames;
+}
+
+/*
+1. This method fills stats with the pool's counters since initBufferPool and a snapshot of its frames and replacement strategy
+2. The frames and the strategy's state are read under the pool latch, so they are consistent with each other; the counters
+are updated without it and may be a few pins ahead
+3. Returns RC_BUFFER_POOL_NOT_INIT if the pool is not initialized
+*/
+RC getPoolStats(BM_BufferPool *const bm, BM_PoolStats *const stats)
+{
+	if (!CheckValidManagementData(bm))
+		return RC_BUFFER_POOL_NOT_INIT;
+	BufferManager *bufferManager = bm->mgmtData;
+	LFUBucket *bucket;
+	int i;
+
+	memset(stats, 0, sizeof(BM_PoolStats));
+	pthread_rwlock_rdlock(&bufferManager->framesLatch);
+	pthread_mutex_lock(&bufferManager->poolLatch);
+	stats->strategy = bm->strategy;
+	stats->numFrames = bufferManager->numFrames;
+	for (i = 0; i < bufferManager->numFrames; i++)
+	{
+		if (bufferManager->frames[i]->pageNumber != NO_PAGE)
+			stats->residentPages++;
+		if (bufferManager->frames[i]->count > 0)
+			stats->pinnedFrames++;
+	}
+	stats->dirtyPages = bufferManager->numDirty;
+	stats->hits = bufferManager->numHits;
+	stats->misses = bufferManager->numMisses;
+	stats->prefetchHits = bufferManager->numPrefetchHits;
+	stats->cleanEvictions = bufferManager->numCleanEvictions;
+	stats->dirtyEvictions = bufferManager->numDirtyEvictions;
+	stats->reads = bufferManager->numRead;
+	stats->writes = bufferManager->numWrite;
+	stats->evictionWrites = bufferManager->numEvictionWrites;
+	stats->flushWrites = bufferManager->numFlushWrites;
+	stats->pinWaits = bufferManager->numPinWaits;
+	stats->pinWaitMicros = bufferManager->pinWaitMicros;
+	if (bm->strategy == RS_CLOCK)
+		stats->clockSecondChances = bufferManager->clockSecondChances;
+	else if (bm->strategy == RS_LFU)
+	{
+		stats->lfuAgings = bufferManager->lfuAgings;
+		for (bucket = bufferManager->lfuLowest; bucket != NULL; bucket = bucket->nextBucket)
+			stats->lfuBuckets++;
+		stats->lfuLowestFrequency = (bufferManager->lfuLowest != NULL) ? bufferManager->lfuLowest->frequency : 0;
+	}
+	else if (bm->strategy == RS_LRU_K)
+	{
+		stats->lrukRetainedHits = bufferManager->lrukRetainedHits;
+		for (i = 0; i < bufferManager->lrukRetainedSize; i++)
+			if (bufferManager->lrukRetained[i].pageNumber != NO_PAGE)
+				stats->lrukRetainedPages++;
+	}
+	else if (bm->strategy == RS_ARC)
+	{
+		stats->arcTarget = bufferManager->arcTarget;
+		stats->arcT1 = bufferManager->arcT1.size;
+		stats->arcT2 = bufferManager->arcT2.size;
+		stats->arcB1 = bufferManager->arcB1.size;
+		stats->arcB2 = bufferManager->arcB2.size;
+		stats->arcB1Hits = bufferManager->arcB1Hits;
+		stats->arcB2Hits = bufferManager->arcB2Hits;
+	}
+	pthread_mutex_unlock(&bufferManager->poolLatch);
+	pthread_rwlock_unlock(&bufferManager->framesLatch);
+	return RC_OK;
+}
+
 /*
 Ramya Krishnan(rkrishnan1@hawk.iit.edu) - A20506653
 1. This method gets the number of pages read from the buffer pool since initialized
@@ -748,3 +3812,24 @@ int getNumWriteIO(BM_BufferPool *const bm)
 	else
 		return ((BufferManager *)bm->mgmtData)->numWrite;
 }
+
+/*
+1. This method gets the number of pages of the pool's files that failed checksum verification since they were opened
+2. Inputs- buffer pool object
+3. returns - Returns the number of checksum mismatches seen by the storage manager
+*/
+int getNumChecksumErrors(BM_BufferPool *const bm)
+{
+	int numErrors = 0;
+	int i;
+	// checks if pool has been init
+	if (!CheckValidManagementData(bm))
+		return RC_BUFFER_POOL_NOT_INIT;
+	BufferManager *bufferManager = bm->mgmtData;
+	pthread_mutex_lock(&bufferManager->filesLatch);
+	for (i = 0; i < BM_MAX_PAGE_FILES; i++)
+		if (bufferManager->files[i] != NULL)
+			numErrors += getNumPageChecksumErrors(bufferManager->files[i]);
+	pthread_mutex_unlock(&bufferManager->filesLatch);
+	return numErrors;
+}
@@ -7,17 +7,21 @@
 // Include bool DT
 #include "dt.h"
 
+// Include the page file handle owned by a buffer pool
+#include "storage_mgr.h"
+
 // Replacement Strategies
 typedef enum ReplacementStrategy {
 	RS_FIFO = 0,
 	RS_LRU = 1,
 	RS_CLOCK = 2,
 	RS_LFU = 3,
-	RS_LRU_K = 4
+	RS_LRU_K = 4,
+	RS_ARC = 5
 } ReplacementStrategy;
 
 // Data Types and Structures
-typedef int PageNumber;
+typedef int64_t PageNumber; // 64 bit, same width as the storage manager page numbers
 #define NO_PAGE -1
 
 typedef struct BM_BufferPool {
@@ -31,8 +35,71 @@ typedef struct BM_BufferPool {
 typedef struct BM_PageHandle {
 	PageNumber pageNum;
 	char *data;
+	int fileId; // page file of the page among those sharing the pool, set by the pins (0: the pool's own file)
 } BM_PageHandle;
 
+// Optional pool settings, filled with defaults by initPoolOptions
+typedef struct BM_PoolOptions {
+	SM_IOMode ioMode; // I/O backend of the pool's page file (SM_IO_DIRECT: the pool is the only page cache)
+	int ioQueueDepth; // requests kept in flight on the async I/O engine, 0 = synchronous I/O
+	int backgroundFlush; // 1: a flusher thread writes dirty unpinned pages ahead of eviction
+	int flushInterval; // milliseconds between two rounds of the flusher
+	int dirtyHighRatio; // percent of the frames dirty that wakes the flusher before its interval is up
+	int dirtyLowRatio; // percent of the frames a round of the flusher leaves dirty
+	int hugePages; // 1: back the frame arena with huge pages (MAP_HUGETLB, else transparent huge pages)
+	int pageSize; // bytes per frame of a pool initialized without a page file of its own, PAGE_SIZE by default
+	int warmUp; // 1: the pages resident at shutdown/detach are saved to <page file>.warm and loaded again in the background at init/attach
+} BM_PoolOptions;
+
+// Optional stratData of an RS_LFU pool, read once by initBufferPool
+typedef struct BM_LFUData {
+	int agingInterval; // pins between two agings that halve the use count of every page, 0 = no aging
+} BM_LFUData;
+
+// Optional stratData of an RS_LRU_K pool, read once by initBufferPool (NULL: LRU-2, no correlated period, numPages retained pages)
+typedef struct BM_LRUKData {
+	int k; // references per page whose times are kept, 2 if 0
+	int correlatedPeriod; // pins after a reference during which further references to the page count as the same one
+	int historySize; // evicted pages whose reference times are retained, 0 = none
+} BM_LRUKData;
+
+// Ring of a few frames a bulk read such as a table scan recycles, set up by initScanRing
+typedef struct BM_ScanRing {
+	int numFrames;
+	int fileId; // page file the ring reads
+	void *mgmtData;
+} BM_ScanRing;
+
+// Counters of a pool since initBufferPool and the state of its frames, filled by getPoolStats
+typedef struct BM_PoolStats {
+	ReplacementStrategy strategy;
+	int numFrames;
+	int residentPages; // frames holding a page
+	int dirtyPages;
+	int pinnedFrames;
+	int64_t hits; // pins that found their page in the pool
+	int64_t misses; // pins that loaded their page
+	int64_t prefetchHits; // first pins of prefetched pages, counted among the hits
+	int64_t cleanEvictions; // clean pages replaced to make room (pins, prefetches, resizeBufferPool)
+	int64_t dirtyEvictions; // dirty pages replaced, written back first
+	int64_t reads;
+	int64_t writes;
+	int64_t evictionWrites; // writes of dirty pages being replaced
+	int64_t flushWrites; // writes of forcePage, forceFlushPool, detachPageFile and the background flusher
+	int64_t pinWaits; // pins that waited for another thread's I/O on their page or frame
+	int64_t pinWaitMicros; // time those pins waited
+	// replacement strategy internals, 0 for the other strategies
+	int64_t clockSecondChances; // CLOCK: reference bits cleared by the hand
+	int64_t lfuAgings; // LFU: agings that halved the use counts
+	int lfuBuckets; // LFU: distinct use counts, and the lowest of them
+	int lfuLowestFrequency;
+	int64_t lrukRetainedHits; // LRU-K: pages loaded again whose retained reference times were restored
+	int lrukRetainedPages; // LRU-K: evicted pages whose reference times are retained
+	int arcTarget; // ARC: target size of T1, sizes of its lists and misses on ghosts of B1 / B2
+	int arcT1, arcT2, arcB1, arcB2;
+	int64_t arcB1Hits, arcB2Hits;
+} BM_PoolStats;
+
 // convenience macros
 #define MAKE_POOL()					\
 		((BM_BufferPool *) malloc (sizeof(BM_BufferPool)))
@@ -44,8 +111,24 @@ typedef struct BM_PageHandle {
 RC initBufferPool(BM_BufferPool *const bm, const char *const pageFileName, 
 		const int numPages, ReplacementStrategy strategy,
 		void *stratData);
+RC initBufferPoolWithOptions(BM_BufferPool *const bm, const char *const pageFileName, 
+		const int numPages, ReplacementStrategy strategy,
+		void *stratData, BM_PoolOptions *const options);
+void initPoolOptions(BM_PoolOptions *const options);
 RC shutdownBufferPool(BM_BufferPool *const bm);
 RC forceFlushPool(BM_BufferPool *const bm);
+// Changes the pool to numPages frames while it is in use; a shrink evicts unpinned pages, pinned pages keep their frames
+RC resizeBufferPool(BM_BufferPool *const bm, const int numPages);
+
+// Shared pools: further page files share the pool's frames, their pages are pinned by the file id attachPageFile returns.
+// Id 0 is the file the pool was initialized with; a pool initialized with a NULL file name serves attached files only
+RC attachPageFile (BM_BufferPool *const bm, const char *const pageFileName, int *fileId);
+RC detachPageFile (BM_BufferPool *const bm, const int fileId);
+RC pinFilePage (BM_BufferPool *const bm, const int fileId, BM_PageHandle *const page,
+		const PageNumber pageNum);
+RC prefetchFilePages (BM_BufferPool *const bm, const int fileId, const PageNumber startPage, const int count);
+// Deletes the warm-up list a pool with warmUp keeps for pageFileName; call it when the page file is destroyed
+RC destroyWarmUpList (const char *const pageFileName);
 
 // Buffer Manager Interface Access Pages
 RC markDirty (BM_BufferPool *const bm, BM_PageHandle *const page);
@@ -53,12 +136,36 @@ RC unpinPage (BM_BufferPool *const bm, BM_PageHandle *const page);
 RC forcePage (BM_BufferPool *const bm, BM_PageHandle *const page);
 RC pinPage (BM_BufferPool *const bm, BM_PageHandle *const page, 
 		const PageNumber pageNum);
+// Loads count pages from startPage on in the background; later pins of them wait only for reads still in flight
+RC prefetchPages (BM_BufferPool *const bm, const PageNumber startPage, const int count);
+
+// Bulk reads: misses of pinPageWithRing and prefetches of prefetchRingPages load their pages into the ring's frames,
+// leaving the rest of the pool's contents alone
+RC initScanRing (BM_BufferPool *const bm, BM_ScanRing *const ring, const int numFrames);
+RC initFileScanRing (BM_BufferPool *const bm, const int fileId, BM_ScanRing *const ring, const int numFrames);
+RC shutdownScanRing (BM_BufferPool *const bm, BM_ScanRing *const ring);
+RC pinPageWithRing (BM_BufferPool *const bm, BM_ScanRing *const ring, BM_PageHandle *const page,
+		const PageNumber pageNum);
+RC prefetchRingPages (BM_BufferPool *const bm, BM_ScanRing *const ring, const PageNumber startPage, const int count);
+
+// Content latch of a pinned page: shared for readers, exclusive for writers. Pins never wait for it,
+// writing the page out (forcePage, forceFlushPool, eviction) waits for an exclusive holder
+RC latchPage (BM_BufferPool *const bm, BM_PageHandle *const page, const int exclusive);
+RC unlatchPage (BM_BufferPool *const bm, BM_PageHandle *const page);
+
+// Page file opened by the pool (header metadata, page count)
+SM_FileHandle *getPoolFileHandle (BM_BufferPool *const bm);
+SM_FileHandle *getPageFileHandle (BM_BufferPool *const bm, const int fileId);
 
 // Statistics Interface
 PageNumber *getFrameContents (BM_BufferPool *const bm);
 bool *getDirtyFlags (BM_BufferPool *const bm);
 int *getFixCounts (BM_BufferPool *const bm);
+// The three arrays above taken in one snapshot, returns their length (-1 on failure); the caller frees them
+int getPoolContents (BM_BufferPool *const bm, PageNumber **frameContents, bool **dirtyFlags, int **fixCounts);
 int getNumReadIO (BM_BufferPool *const bm);
 int getNumWriteIO (BM_BufferPool *const bm);
+int getNumChecksumErrors (BM_BufferPool *const bm);
+RC getPoolStats (BM_BufferPool *const bm, BM_PoolStats *const stats);
 
 #endif
@@ -3,9 +3,16 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdarg.h>
+
+// size of the message sprintPoolStats returns, longer output is cut off
+#define STATS_MESSAGE_SIZE 1024
 
 // local functions
 static void printStrat (BM_BufferPool *const bm);
+static const char *stratName (ReplacementStrategy strategy);
+static void appendStats (char *message, int *pos, const char *format, ...);
+static void sprintStrategyStats (char *message, int *pos, BM_PoolStats *stats, BM_StatsFormat format);
 
 // external functions
 void 
@@ -14,19 +21,23 @@ printPoolContent (BM_BufferPool *const bm)
 	PageNumber *frameContent;
 	bool *dirty;
 	int *fixCount;
-	int i;
+	int i, numFrames;
 
-	frameContent = getFrameContents(bm);
-	dirty = getDirtyFlags(bm);
-	fixCount = getFixCounts(bm);
+	// one snapshot, a resize may change the number of frames
+	numFrames = getPoolContents(bm, &frameContent, &dirty, &fixCount);
+	if (numFrames < 0)
+		return;
 
 	printf("{");
 	printStrat(bm);
-	printf(" %i}: ", bm->numPages);
+	printf(" %i}: ", numFrames);
 
-	for (i = 0; i < bm->numPages; i++)
-		printf("%s[%i%s%i]", ((i == 0) ? "" : ",") , frameContent[i], (dirty[i] ? "x": " "), fixCount[i]);
+	for (i = 0; i < numFrames; i++)
+		printf("%s[%lld%s%i]", ((i == 0) ? "" : ",") , (long long) frameContent[i], (dirty[i] ? "x": " "), fixCount[i]);
 	printf("\n");
+	free(frameContent);
+	free(dirty);
+	free(fixCount);
 }
 
 char *
@@ -35,18 +46,23 @@ sprintPoolContent (BM_BufferPool *const bm)
 	PageNumber *frameContent;
 	bool *dirty;
 	int *fixCount;
-	int i;
+	int i, numFrames;
 	char *message;
 	int pos = 0;
 
-	message = (char *) malloc(256 + (22 * bm->numPages));
-	frameContent = getFrameContents(bm);
-	dirty = getDirtyFlags(bm);
-	fixCount = getFixCounts(bm);
+	numFrames = getPoolContents(bm, &frameContent, &dirty, &fixCount);
+	if (numFrames < 0)
+		return NULL;
+	message = (char *) malloc(256 + (36 * numFrames));
+	if (message != NULL)
+		message[0] = '\0';
 
-	for (i = 0; i < bm->numPages; i++)
-		pos += sprintf(message + pos, "%s[%i%s%i]", ((i == 0) ? "" : ",") , frameContent[i], (dirty[i] ? "x": " "), fixCount[i]);
+	for (i = 0; message != NULL && i < numFrames; i++)
+		pos += sprintf(message + pos, "%s[%lld%s%i]", ((i == 0) ? "" : ",") , (long long) frameContent[i], (dirty[i] ? "x": " "), fixCount[i]);
 
+	free(frameContent);
+	free(dirty);
+	free(fixCount);
 	return message;
 }
 
@@ -56,7 +72,7 @@ printPageContent (BM_PageHandle *const page)
 {
 	int i;
 
-	printf("[Page %i]\n", page->pageNum);
+	printf("[Page %lld]\n", (long long) page->pageNum);
 
 	for (i = 1; i <= PAGE_SIZE; i++)
 		printf("%02X%s%s", page->data[i], (i % 8) ? "" : " ", (i % 64) ? "" : "\n");
@@ -70,7 +86,7 @@ sprintPageContent (BM_PageHandle *const page)
 	int pos = 0;
 
 	message = (char *) malloc(30 + (2 * PAGE_SIZE) + (PAGE_SIZE % 64) + (PAGE_SIZE % 8));
-	pos += sprintf(message + pos, "[Page %i]\n", page->pageNum);
+	pos += sprintf(message + pos, "[Page %lld]\n", (long long) page->pageNum);
 
 	for (i = 1; i <= PAGE_SIZE; i++)
 		pos += sprintf(message + pos, "%02X%s%s", page->data[i], (i % 8) ? "" : " ", (i % 64) ? "" : "\n");
@@ -78,25 +94,138 @@ sprintPageContent (BM_PageHandle *const page)
 	return message;
 }
 
+void
+printPoolStats (BM_BufferPool *const bm, BM_StatsFormat format)
+{
+	char *message = sprintPoolStats(bm, format);
+
+	if (message == NULL)
+		return;
+	printf("%s\n", message);
+	free(message);
+}
+
+char *
+sprintPoolStats (BM_BufferPool *const bm, BM_StatsFormat format)
+{
+	BM_PoolStats stats;
+	char *message;
+	double hitRatio;
+	int pos = 0;
+
+	if (getPoolStats(bm, &stats) != RC_OK)
+		return NULL;
+	message = (char *) malloc(STATS_MESSAGE_SIZE);
+	if (message == NULL)
+		return NULL;
+	message[0] = '\0';
+	hitRatio = (stats.hits + stats.misses > 0) ? (double) stats.hits / (stats.hits + stats.misses) : 0.0;
+
+	if (format == BM_STATS_JSON)
+	{
+		appendStats(message, &pos, "{\"strategy\":\"%s\",\"numFrames\":%i,\"residentPages\":%i,\"dirtyPages\":%i,\"pinnedFrames\":%i,",
+				stratName(stats.strategy), stats.numFrames, stats.residentPages, stats.dirtyPages, stats.pinnedFrames);
+		appendStats(message, &pos, "\"hits\":%lld,\"misses\":%lld,\"hitRatio\":%.4f,\"prefetchHits\":%lld,",
+				(long long) stats.hits, (long long) stats.misses, hitRatio, (long long) stats.prefetchHits);
+		appendStats(message, &pos, "\"cleanEvictions\":%lld,\"dirtyEvictions\":%lld,\"reads\":%lld,\"writes\":%lld,\"evictionWrites\":%lld,\"flushWrites\":%lld,",
+				(long long) stats.cleanEvictions, (long long) stats.dirtyEvictions, (long long) stats.reads, (long long) stats.writes,
+				(long long) stats.evictionWrites, (long long) stats.flushWrites);
+		appendStats(message, &pos, "\"pinWaits\":%lld,\"pinWaitMicros\":%lld,\"strategyStats\":{",
+				(long long) stats.pinWaits, (long long) stats.pinWaitMicros);
+		sprintStrategyStats(message, &pos, &stats, format);
+		appendStats(message, &pos, "}}");
+		return message;
+	}
+
+	appendStats(message, &pos, "{%s %i}: hits %lld misses %lld (hit ratio %.1f%%), prefetch hits %lld\n",
+			stratName(stats.strategy), stats.numFrames, (long long) stats.hits, (long long) stats.misses, hitRatio * 100,
+			(long long) stats.prefetchHits);
+	appendStats(message, &pos, "frames: %i resident, %i dirty, %i pinned\n", stats.residentPages, stats.dirtyPages, stats.pinnedFrames);
+	appendStats(message, &pos, "evictions: %lld clean, %lld dirty\n", (long long) stats.cleanEvictions, (long long) stats.dirtyEvictions);
+	appendStats(message, &pos, "I/O: %lld reads, %lld writes (%lld by evictions, %lld by flushes)\n", (long long) stats.reads,
+			(long long) stats.writes, (long long) stats.evictionWrites, (long long) stats.flushWrites);
+	appendStats(message, &pos, "pin waits: %lld (%lld us)", (long long) stats.pinWaits, (long long) stats.pinWaitMicros);
+	sprintStrategyStats(message, &pos, &stats, format);
+	return message;
+}
+
+void
+sprintStrategyStats (char *message, int *pos, BM_PoolStats *stats, BM_StatsFormat format)
+{
+	bool json = (format == BM_STATS_JSON);
+
+	switch (stats->strategy)
+	{
+	case RS_CLOCK:
+		appendStats(message, pos, json ? "\"secondChances\":%lld" : "\nCLOCK: %lld second chances", (long long) stats->clockSecondChances);
+		break;
+	case RS_LFU:
+		appendStats(message, pos, json ? "\"agings\":%lld,\"buckets\":%i,\"lowestFrequency\":%i" : "\nLFU: %lld agings, %i buckets, lowest frequency %i",
+				(long long) stats->lfuAgings, stats->lfuBuckets, stats->lfuLowestFrequency);
+		break;
+	case RS_LRU_K:
+		appendStats(message, pos, json ? "\"retainedHits\":%lld,\"retainedPages\":%i" : "\nLRU-K: %lld retained history hits, %i pages retained",
+				(long long) stats->lrukRetainedHits, stats->lrukRetainedPages);
+		break;
+	case RS_ARC:
+		appendStats(message, pos, json ? "\"target\":%i,\"t1\":%i,\"t2\":%i,\"b1\":%i,\"b2\":%i,\"b1Hits\":%lld,\"b2Hits\":%lld"
+				: "\nARC: target %i, T1 %i, T2 %i, B1 %i, B2 %i, ghost hits B1 %lld B2 %lld",
+				stats->arcTarget, stats->arcT1, stats->arcT2, stats->arcB1, stats->arcB2, (long long) stats->arcB1Hits, (long long) stats->arcB2Hits);
+		break;
+	default:
+		break;
+	}
+}
+
+void
+appendStats (char *message, int *pos, const char *format, ...)
+{
+	va_list args;
+	int written;
+
+	if (*pos >= STATS_MESSAGE_SIZE - 1)
+		return;
+	va_start(args, format);
+	written = vsnprintf(message + *pos, STATS_MESSAGE_SIZE - *pos, format, args);
+	va_end(args);
+	if (written > 0)
+		*pos = (*pos + written < STATS_MESSAGE_SIZE - 1) ? *pos + written : STATS_MESSAGE_SIZE - 1;
+}
+
+const char *
+stratName (ReplacementStrategy strategy)
+{
+	switch (strategy)
+	{
+	case RS_FIFO:
+		return "FIFO";
+	case RS_LRU:
+		return "LRU";
+	case RS_CLOCK:
+		return "CLOCK";
+	case RS_LFU:
+		return "LFU";
+	case RS_LRU_K:
+		return "LRU-K";
+	case RS_ARC:
+		return "ARC";
+	default:
+		return "unknown";
+	}
+}
+
 void
 printStrat (BM_BufferPool *const bm)
 {
 	switch (bm->strategy)
 	{
 	case RS_FIFO:
-		printf("FIFO");
-		break;
 	case RS_LRU:
-		printf("LRU");
-		break;
 	case RS_CLOCK:
-		printf("CLOCK");
-		break;
 	case RS_LFU:
-		printf("LFU");
-		break;
 	case RS_LRU_K:
-		printf("LRU-K");
+	case RS_ARC:
+		printf("%s", stratName(bm->strategy));
 		break;
 	default:
 		printf("%i", bm->strategy);
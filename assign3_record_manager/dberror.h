@@ -18,6 +18,13 @@ typedef int RC;
 #define RC_READ_FAILED 6
 #define RC_BUFFER_POOL_NOT_INIT 7
 #define RC_BUFFER_POOL_EXIST 8
+#define RC_INVALID_FILE_HEADER 9
+#define RC_UNSUPPORTED_FILE_VERSION 10
+#define RC_DIRECT_IO_NOT_SUPPORTED 11
+#define RC_ASYNC_IO_QUEUE_FULL 12
+#define RC_PAGE_CHECKSUM_MISMATCH 13
+#define RC_INVALID_PAGE_SIZE 14
+#define RC_NO_FREE_BUFFER_FRAME 15
 
 #define RC_RM_COMPARE_VALUE_OF_DIFFERENT_DATATYPE 200
 #define RC_RM_EXPR_RESULT_IS_NOT_BOOLEAN 201
@@ -36,6 +43,7 @@ typedef int RC;
 #define RC_TABLE_ALREADY_EXISTS 400
 #define RC_RM_UPDATE_NOT_POSSIBLE_ON_DELETED_RECORD 401
 #define RC_RM_NO_DESERIALIZER_FOR_THIS_DATATYPE 402
+#define RC_RM_RECORD_TOO_LARGE 403
 
 /* holder for error messages */
 extern char *RC_message;
@@ -2,6 +2,7 @@
 #include "stdlib.h"
 #include "string.h"
 #include "unistd.h"
+#include "pthread.h"
 #include "buffer_mgr.h"
 #include "storage_mgr.h"
 #include "record_mgr.h"
@@ -17,21 +18,37 @@ typedef struct RM_TableDetail
 // Record Manager Struct.
 typedef struct RecordManager
 {
-	BM_BufferPool *bufferPool;
-	int *freePages;
+	BM_BufferPool *bufferPool; // the shared pool, or a pool of the table's own if its pages do not fit the shared frames
+	int fileId;				   // the table's page file among those of bufferPool
+	PageNumber numPages;	   // pages of the table's file, each open table keeps its own
+	PageNumber *freePages;
 } RecordManager;
 
+// frames of the buffer pool all open tables share
+#define RM_BUFFER_POOL_FRAMES 32
+
+// the shared pool exists while at least one table that uses it is open
+BM_BufferPool *sharedPool = NULL;
+int sharedPoolTables = 0;
+pthread_mutex_t sharedPoolLatch = PTHREAD_MUTEX_INITIALIZER;
+
+// pages a scan asks the buffer pool to load ahead of its cursor unless setScanPrefetchDistance changes it
+#define RM_SCAN_PREFETCH_DISTANCE 4
+// frames a bulk-read scan recycles, the buffer pool caps them at half of its frames
+#define RM_SCAN_RING_FRAMES 3
+
 // Scan Manager Struct.
 typedef struct RM_ScanManager
 {
 	Record *currentRecord;
 	int currentSlot;
 	Expr *expr;
-	int currentPage;
+	PageNumber currentPage;
+	int prefetchDistance;
+	PageNumber prefetchedUpTo; // pages before it were already handed to prefetchFilePages
+	BM_ScanRing ring;		   // frames of an RM_SCAN_BULK_READ scan, mgmtData is NULL for other scans
 } RM_ScanManager;
 
-int totalNumberOfPages;
-
 // calls the Mark Dirty function from buffer pool
 void markDirtyInfo(RM_TableData *rel, BM_PageHandle *page)
 {
@@ -44,23 +61,24 @@ void unpinPageInfo(RM_TableData *rel, BM_PageHandle *page)
 	unpinPage(((RecordManager *)rel->mgmtData)->bufferPool, page);
 }
 
-// calls the Force page function from buffer pool
-void forcePageInfo(RM_TableData *rel, BM_PageHandle *page)
+// latches a pinned page exclusive before it is changed, so the background flusher does not write it half changed
+void latchPageInfo(RM_TableData *rel, BM_PageHandle *page)
 {
-	forcePage(((RecordManager *)rel->mgmtData)->bufferPool, page);
+	latchPage(((RecordManager *)rel->mgmtData)->bufferPool, page, 1);
 }
 
 /*
 Ramya Krishnan(rkrishnan1@hawk.iit.edu) - A20506653
-1. This method calls dirty info, unpin page and force page functions
-2. Inputs- void
-3. returns - Returns void
+1. This method calls dirty info and unpin page functions, the pool's background flusher writes the page later
+2. Releases the latch taken by latchPageInfo before the unpin
+3. Inputs- void
+4. returns - Returns void
 */
 void ModifyPageDetails(RM_TableData *rel, BM_PageHandle *page)
 {
 	markDirtyInfo(rel, page);
+	unlatchPage(((RecordManager *)rel->mgmtData)->bufferPool, page);
 	unpinPageInfo(rel, page);
-	forcePageInfo(rel, page);
 }
 
 RC SetOffAttrValue(Schema *schema, int attrNum, int *result)
@@ -150,6 +168,16 @@ Ramya Krishnan(rkrishnan1@hawk.iit.edu) - A20506653
 3. returns - Returns RC code
 */
 RC createTable(char *name, Schema *schema)
+{
+	return createTableWithPageSize(name, schema, PAGE_SIZE);
+}
+
+/*
+1. This method creates a table whose page file uses pageSize byte pages (4 KiB to 64 KiB)
+2. Larger pages suit tables that are mostly scanned, small ones point lookups
+3. returns - Returns RC_INVALID_PAGE_SIZE for an unsupported size, RC_RM_RECORD_TOO_LARGE if the schema does not fit a page
+*/
+RC createTableWithPageSize(char *name, Schema *schema, int pageSize)
 {
 	printf("Create table is started\n");
 	int value = 0;
@@ -158,49 +186,127 @@ RC createTable(char *name, Schema *schema)
 
 	RM_TableDetail *tableDetail = createTableDetailObject();
 
-	RC returnCreatePage = createPageFile(name);
+	RC returnCreatePage = createPageFileWithSize(name, pageSize);
+	if (returnCreatePage == RC_INVALID_PAGE_SIZE)
+	{
+		free(info);
+		return returnCreatePage;
+	}
 	RC returnOpenPage = openPageFile(name, &filehandle);
 	checkIfFileExist(returnCreatePage, returnOpenPage);
 
 	tableDetail->schemaSize = value;
-	RC writeflag = writeBlock(value, &filehandle, info);
+	if (strlen(info) >= SM_PAGE_DATA_BYTES(pageSize))
+	{
+		free(info);
+		closePageFile(&filehandle);
+		return RC_RM_RECORD_TOO_LARGE;
+	}
+	// the schema string is shorter than a page; the page (and its checksum trailer) is written from a full page buffer
+	SM_PageHandle schemaPage = (SM_PageHandle)calloc(1, pageSize);
+	strcpy(schemaPage, info);
+	RC writeflag = writeBlock(value, &filehandle, schemaPage);
+	free(schemaPage);
+	free(info);
+	closePageFile(&filehandle);
 	return (writeflag == RC_OK) ? RC_OK : RC_WRITE_FAILED;
 	printf("Create table is ended\n");
 }
 
-// Total page value is set from the read Header
-char SetTotalPages(char *readHeader)
+// Calls init buffer pool function from buffer pool class
+// LFU with aging, background flusher and warm-up; name is NULL for the shared pool
+RC callInitBufferPool(BM_BufferPool *const bufferPool, char *name, int numFrames)
 {
-	char *totalPage;
-	totalPage = readHeader;
-	return atoi(totalPage);
+	BM_LFUData lfuData;
+	BM_PoolOptions options;
+	lfuData.agingInterval = 1024;
+	initPoolOptions(&options);
+	options.backgroundFlush = 1;
+	options.warmUp = 1;
+	return initBufferPoolWithOptions(bufferPool, name, numFrames, RS_LFU, &lfuData, &options);
 }
 
-// Opens a file and returns the object
-FILE *fileReturn(char *name)
+// Calls pin page function from pin page class
+void callPinPage(RecordManager *recordManager, BM_PageHandle *const page, PageNumber pageNum)
 {
-	FILE *file = fopen(name, "r+");
-	return file;
+	pinFilePage(recordManager->bufferPool, recordManager->fileId, page, pageNum);
 }
 
-// Calls the fgets method to get the file
-void getFile(char *readHeader, FILE *file)
+// page file of the table in its buffer pool
+SM_FileHandle *getTableFileHandle(RM_TableData *rel)
 {
-	fgets(readHeader, PAGE_SIZE, file);
+	RecordManager *recordManager = (RecordManager *)rel->mgmtData;
+	return getPageFileHandle(recordManager->bufferPool, recordManager->fileId);
 }
 
-// Calls init buffer pool function from buffer pool class
-void callInitBufferPool(BM_BufferPool *const bufferPool, char *name)
+/*
+1. This method attaches the table's page file to the buffer pool shared by all open tables, creating the pool for the
+first table
+2. A table whose page size differs from the shared frames gets a pool of its own with the same settings
+3. returns - Returns the RC code of opening the page file
+*/
+RC attachTablePool(RecordManager *recordManager, char *name)
 {
 	int six = 6;
-	initBufferPool(bufferPool, name, six, RS_FIFO, NULL);
+	RC returnCode = RC_OK;
+	pthread_mutex_lock(&sharedPoolLatch);
+	if (sharedPool == NULL)
+	{
+		sharedPool = MAKE_POOL();
+		returnCode = callInitBufferPool(sharedPool, NULL, RM_BUFFER_POOL_FRAMES);
+		if (returnCode != RC_OK)
+		{
+			free(sharedPool);
+			sharedPool = NULL;
+			pthread_mutex_unlock(&sharedPoolLatch);
+			return returnCode;
+		}
+	}
+	returnCode = attachPageFile(sharedPool, name, &recordManager->fileId);
+	if (returnCode == RC_OK)
+	{
+		recordManager->bufferPool = sharedPool;
+		sharedPoolTables++;
+	}
+	else if (sharedPoolTables == 0)
+	{
+		shutdownBufferPool(sharedPool);
+		free(sharedPool);
+		sharedPool = NULL;
+	}
+	pthread_mutex_unlock(&sharedPoolLatch);
+	if (returnCode != RC_INVALID_PAGE_SIZE)
+		return returnCode;
+	recordManager->bufferPool = MAKE_POOL();
+	recordManager->fileId = 0;
+	returnCode = callInitBufferPool(recordManager->bufferPool, name, six);
+	if (returnCode != RC_OK)
+		free(recordManager->bufferPool);
+	return returnCode;
 }
 
-// Calls pin page function from pin page class
-void callPinPage(BM_BufferPool *const bufferPool, BM_PageHandle *const page)
+// detaches the table's page file, the last table closed shuts the shared pool down
+// a failed detach (a page still pinned by an open scan) keeps the table attached and returns the error
+RC detachTablePool(RecordManager *recordManager)
 {
-	int zero = 0;
-	pinPage(bufferPool, page, 0);
+	RC returnCode;
+	if (recordManager->bufferPool != sharedPool)
+	{
+		returnCode = shutdownBufferPool(recordManager->bufferPool);
+		if (returnCode == RC_OK)
+			free(recordManager->bufferPool);
+		return returnCode;
+	}
+	pthread_mutex_lock(&sharedPoolLatch);
+	returnCode = detachPageFile(sharedPool, recordManager->fileId);
+	if (returnCode == RC_OK && --sharedPoolTables == 0)
+	{
+		shutdownBufferPool(sharedPool);
+		free(sharedPool);
+		sharedPool = NULL;
+	}
+	pthread_mutex_unlock(&sharedPoolLatch);
+	return returnCode;
 }
 
 /*
@@ -213,23 +319,25 @@ RC openTable(RM_TableData *rel, char *name)
 {
 	printf("Open table is started\n");
 	RecordManager *recordManager = createRecordManagerObject();
-	FILE *file = fileReturn(name);
-	char *readHeader;
-	readHeader = (char *)calloc(PAGE_SIZE, sizeof(char));
-	getFile(readHeader, file);
-	totalNumberOfPages = SetTotalPages(readHeader);
-	recordManager->bufferPool = MAKE_POOL();
+	RC attachReturnCode = attachTablePool(recordManager, name);
+	if (attachReturnCode != RC_OK)
+	{
+		free(recordManager);
+		return attachReturnCode;
+	}
 
 	BM_PageHandle *page = MAKE_PAGE_HANDLE();
-	callInitBufferPool(recordManager->bufferPool, name);
-	callPinPage(recordManager->bufferPool, page);
-	recordManager->freePages = (int *)malloc(sizeof(int));
-	recordManager->freePages[0] = totalNumberOfPages;
+	rel->mgmtData = recordManager;
+	// page count comes from the binary header read when the pool opened the file
+	recordManager->numPages = getTableFileHandle(rel)->totalNumPages;
+	callPinPage(recordManager, page, 0);
+	recordManager->freePages = (PageNumber *)malloc(sizeof(PageNumber));
+	recordManager->freePages[0] = recordManager->numPages;
 	rel->name = name;
 	rel->schema = deserializeSchema(page->data);
-	rel->mgmtData = recordManager;
+	// a page left pinned would keep closeTable from detaching the file
+	unpinPage(recordManager->bufferPool, page);
 	free(page);
-	free(readHeader);
 	printf("Open table is ended\n");
 	return RC_OK;
 }
@@ -260,7 +368,9 @@ RC closeTable(RM_TableData *rel)
 	printf("close table is started\n");
 	RecordManager *recordManager = createRecordManagerObject();
 	recordManager = rel->mgmtData;
-	shutdownBufferPool(recordManager->bufferPool);
+	RC returnCode = detachTablePool(recordManager);
+	if (returnCode != RC_OK)
+		return returnCode;
 	freeAttr(recordManager, rel);
 	printf("close table is ended\n");
 	return RC_OK;
@@ -276,10 +386,30 @@ RC deleteTable(char *name)
 {
 	printf("delete table is started\n");
 	RC destroyFlag = destroyPageFile(name);
+	destroyWarmUpList(name);
 	return destroyFlag != RC_OK ? RC_FILE_NOT_FOUND : RC_OK;
 	printf("delete table is ended\n");
 }
 
+// adds delta to the tuple count kept in the page file header
+void updateTupleCount(RM_TableData *rel, int delta)
+{
+	SM_FileHeader header;
+	SM_FileHandle *fHandle = getTableFileHandle(rel);
+	if (getFileHeader(fHandle, &header) == RC_OK)
+	{
+		header.tupleCount = header.tupleCount + delta;
+		setFileHeader(fHandle, &header);
+	}
+}
+
+// true if a serialized record fits in the usable part of a page of the table's file
+bool recordFitsPage(RM_TableData *rel, char *serializedRecord)
+{
+	SM_FileHandle *fHandle = getTableFileHandle(rel);
+	return strlen(serializedRecord) < SM_PAGE_DATA_BYTES(fHandle->pageSize);
+}
+
 // created record object
 Record *createRecordObject()
 {
@@ -291,31 +421,15 @@ Record *createRecordObject()
 Ramya Krishnan(rkrishnan1@hawk.iit.edu) - A20506653
 1. This method is used to get the tuples value
 2. Inputs- name of the tabble
-3. returns - Returns tuple value
+3. returns - Returns tuple value kept in the page file header (no scan needed)
 */
 int getNumTuples(RM_TableData *rel)
 {
-	Record *record = createRecordObject();
-	RID ridValue;
-	RC flagGetRecord;
-	int one = 1;
-	int zero = 0;
-	int total = zero;
-	ridValue.page = one;
-	ridValue.slot = zero;
-	if (ridValue.page < totalNumberOfPages && ridValue.page > 0)
-	{
-		flagGetRecord = getRecord(rel, ridValue, record);
-		if (flagGetRecord == RC_OK)
-		{
-			total += one;
-			ridValue.page += one;
-			ridValue.slot = zero;
-		}
-	}
-	record = NULL;
-	free(record);
-	return total;
+	SM_FileHeader header;
+	SM_FileHandle *fHandle = getTableFileHandle(rel);
+	if (getFileHeader(fHandle, &header) != RC_OK)
+		return 0;
+	return (int)header.tupleCount;
 }
 
 char *callSerializeRecord(Record *record, RM_TableData *rel)
@@ -345,7 +459,7 @@ RC insertRecord(RM_TableData *rel, Record *record)
 	rid.page = one;
 	rid.slot = zero;
 
-	while (rid.page < totalNumberOfPages && rid.page > zero)
+	while (rid.page < ((RecordManager *)rel->mgmtData)->numPages && rid.page > zero)
 	{
 		rid.page = rid.page + one;
 		rid.slot = zero;
@@ -354,21 +468,28 @@ RC insertRecord(RM_TableData *rel, Record *record)
 	free(record1);
 	((RecordManager *)rel->mgmtData)->freePages[0] = rid.page;
 	BM_PageHandle *page = MAKE_PAGE_HANDLE();
-	int freepage = ((RecordManager *)rel->mgmtData)->freePages[0];
+	PageNumber freepage = ((RecordManager *)rel->mgmtData)->freePages[0];
 	record->id.page = freepage;
 	record->id.slot = zero;
 	Schema *schema = rel->schema;
 	char *serializedRecord = serializeRecord(record, schema);
-	BM_BufferPool *bufferPool = ((RecordManager *)rel->mgmtData)->bufferPool;
-	int freepage1 = ((RecordManager *)rel->mgmtData)->freePages[0];
-	pinPage(bufferPool, page, freepage1);
+	if (!recordFitsPage(rel, serializedRecord))
+	{
+		free(serializedRecord);
+		free(page);
+		return RC_RM_RECORD_TOO_LARGE;
+	}
+	PageNumber freepage1 = ((RecordManager *)rel->mgmtData)->freePages[0];
+	callPinPage((RecordManager *)rel->mgmtData, page, freepage1);
+	latchPageInfo(rel, page);
 	char *dt = page->data;
 	memorySet(dt);
 	sprintf(page->data, "%s", serializedRecord);
 	ModifyPageDetails(rel, page);
 	free(page);
+	updateTupleCount(rel, one);
 	((RecordManager *)rel->mgmtData)->freePages[0] = ((RecordManager *)rel->mgmtData)->freePages[0] + one;
-	totalNumberOfPages = totalNumberOfPages + one;
+	((RecordManager *)rel->mgmtData)->numPages = ((RecordManager *)rel->mgmtData)->numPages + one;
 	printf("insert record is ended\n");
 	return RC_OK;
 }
@@ -397,20 +518,24 @@ RC deleteRecord(RM_TableData *rel, RID id)
 	char deleteFlag[3] = "DEL";
 	char *flag = CreateCharObject();
 	int zero = 0;
-	if (id.page < zero || id.page > totalNumberOfPages)
+	if (id.page < zero || id.page > ((RecordManager *)rel->mgmtData)->numPages)
 		return RC_RM_NO_MORE_TUPLES;
 	else
 	{
 		BM_PageHandle *page = MAKE_PAGE_HANDLE();
-		int pg = id.page;
-		BM_BufferPool *bufferPool = ((RecordManager *)rel->mgmtData)->bufferPool;
-		pinPage(bufferPool, page, pg);
+		PageNumber pg = id.page;
+		callPinPage((RecordManager *)rel->mgmtData, page, pg);
+		latchPageInfo(rel, page);
+		// records already carrying the tombstone are not counted again
+		bool alreadyDeleted = (strncmp(page->data, deleteFlag, sizeof(deleteFlag)) == 0);
 		stringOperation(flag, deleteFlag, page->data);
 		page->pageNum = id.page;
 		char *dt = page->data;
 		memorySet(dt);
 		sprintf(page->data, "%s", flag);
 		ModifyPageDetails(rel, page);
+		if (!alreadyDeleted)
+			updateTupleCount(rel, -1);
 		page = NULL;
 		free(page);
 		return RC_OK;
@@ -428,19 +553,25 @@ RC updateRecord(RM_TableData *rel, Record *record)
 	printf("update record is started\n");
 	printf("record updated: %s\n", record->data);
 	int zero = 0;
-	if (record->id.page > totalNumberOfPages && record->id.page <= zero)
+	if (record->id.page > ((RecordManager *)rel->mgmtData)->numPages && record->id.page <= zero)
 		return RC_RM_NO_MORE_TUPLES;
 	else
 	{
 		BM_PageHandle *page = MAKE_PAGE_HANDLE();
-		int pageNumber;
+		PageNumber pageNumber;
 		int slotNumber;
 		slotNumber = record->id.slot;
 		pageNumber = record->id.page;
-		BM_BufferPool *bufferPool = ((RecordManager *)rel->mgmtData)->bufferPool;
 		char *record_str = serializeRecord(record, rel->schema);
-		int pg = record->id.page;
-		pinPage(bufferPool, page, pg);
+		if (!recordFitsPage(rel, record_str))
+		{
+			free(record_str);
+			free(page);
+			return RC_RM_RECORD_TOO_LARGE;
+		}
+		PageNumber pg = record->id.page;
+		callPinPage((RecordManager *)rel->mgmtData, page, pg);
+		latchPageInfo(rel, page);
 		char *dt = page->data;
 		memorySet(dt);
 		sprintf(page->data, "%s", record_str);
@@ -453,26 +584,27 @@ RC updateRecord(RM_TableData *rel, Record *record)
 }
 
 /*
-Ramya Krishnan(rkrishnan1@hawk.iit.edu) - A20506653
-1. This method is used to get the records from table with rid value
-2. Inputs- tabble data, rid and record
-3. returns - Returns RC value
+1. This method is the body of getRecord; with a scan ring the page is pinned through the ring, so a miss does not
+replace a page of the rest of the pool
 */
-RC getRecord(RM_TableData *rel, RID id, Record *record)
+RC readRecord(RM_TableData *rel, RID id, Record *record, BM_ScanRing *ring)
 {
 	printf("get record is started\n");
 	int zero = 0;
 	int three = 3;
 	char deleteFlag[3] = "DEL";
-	if (id.page > totalNumberOfPages && id.page <= zero)
+	if (id.page > ((RecordManager *)rel->mgmtData)->numPages && id.page <= zero)
 		return RC_RM_NO_MORE_TUPLES;
 	else
 	{
 		record->id = id;
 		BM_PageHandle *page = MAKE_PAGE_HANDLE();
 		BM_BufferPool *bufferPool = ((RecordManager *)rel->mgmtData)->bufferPool;
-		int pg = id.page;
-		pinPage(bufferPool, page, pg);
+		PageNumber pg = id.page;
+		if (ring != NULL)
+			pinPageWithRing(bufferPool, ring, page, pg);
+		else
+			callPinPage((RecordManager *)rel->mgmtData, page, pg);
 		char *dt = page->data;
 		char *record_data = (char *)malloc(sizeof(char) * strlen(dt));
 		strcpy(record_data, dt);
@@ -494,6 +626,17 @@ RC getRecord(RM_TableData *rel, RID id, Record *record)
 	}
 }
 
+/*
+Ramya Krishnan(rkrishnan1@hawk.iit.edu) - A20506653
+1. This method is used to get the records from table with rid value
+2. Inputs- tabble data, rid and record
+3. returns - Returns RC value
+*/
+RC getRecord(RM_TableData *rel, RID id, Record *record)
+{
+	return readRecord(rel, id, record, NULL);
+}
+
 RM_ScanManager *createScanManagerObject()
 {
 	return (RM_ScanManager *)malloc(sizeof(RM_ScanManager));
@@ -506,6 +649,16 @@ RM_ScanManager *AssignScanManager(RM_ScanManager *scanManager)
 }
 
 RC startScan(RM_TableData *rel, RM_ScanHandle *scan, Expr *cond)
+{
+	return startScanWithMode(rel, scan, cond, RM_SCAN_NORMAL);
+}
+
+/*
+1. This method starts a scan like startScan; mode RM_SCAN_BULK_READ reads the table through a small ring of buffer frames
+that the scan recycles, so the pages the scan loads do not push the rest of the pool's pages out
+2. Returns the error of initFileScanRing if the ring cannot be set up
+*/
+RC startScanWithMode(RM_TableData *rel, RM_ScanHandle *scan, Expr *cond, RM_ScanMode mode)
 {
 	int zero = 0;
 	int one = 1;
@@ -514,15 +667,74 @@ RC startScan(RM_TableData *rel, RM_ScanHandle *scan, Expr *cond)
 	scan->rel = rel;
 	scanManager->currentSlot = zero;
 	scanManager->currentPage = one;
+	scanManager->prefetchDistance = RM_SCAN_PREFETCH_DISTANCE;
+	scanManager->prefetchedUpTo = one;
+	scanManager->ring.numFrames = zero;
+	scanManager->ring.mgmtData = NULL;
+	if (mode == RM_SCAN_BULK_READ)
+	{
+		RecordManager *recordManager = (RecordManager *)rel->mgmtData;
+		RC ringReturnCode = initFileScanRing(recordManager->bufferPool, recordManager->fileId, &scanManager->ring, RM_SCAN_RING_FRAMES);
+		if (ringReturnCode != RC_OK)
+		{
+			free(scanManager->currentRecord);
+			free(scanManager);
+			return ringReturnCode;
+		}
+		// read-ahead goes into the ring as well, it keeps one frame for the page being read
+		scanManager->prefetchDistance = scanManager->ring.numFrames - one;
+	}
 	Expr *expr = cond;
 	scanManager->expr = expr;
 	scan->mgmtData = AssignScanManager(scanManager);
 	return RC_OK;
 }
 
-int AssignCurrentPage(RM_ScanHandle *scan)
+/*
+1. This method sets how many pages a scan keeps loading ahead of its cursor, 0 turns read-ahead off
+2. Returns RC_OK
+*/
+RC setScanPrefetchDistance(RM_ScanHandle *scan, int distance)
+{
+	((RM_ScanManager *)scan->mgmtData)->prefetchDistance = (distance > 0) ? distance : 0;
+	return RC_OK;
+}
+
+/*
+1. This method keeps the buffer pool loading the pages after page, the page the scan reads next
+2. The window is refilled once the cursor has used up half of it, so prefetchFilePages gets a few pages at a time
+*/
+void prefetchScanPages(RM_ScanHandle *scan, PageNumber page)
+{
+	RM_ScanManager *scanManager = (RM_ScanManager *)scan->mgmtData;
+	PageNumber numPages = ((RecordManager *)scan->rel->mgmtData)->numPages;
+	PageNumber end = page + 1 + scanManager->prefetchDistance;
+	if (end > numPages)
+		end = numPages;
+	if (scanManager->prefetchDistance == 0 || scanManager->prefetchedUpTo - page > scanManager->prefetchDistance / 2)
+		return;
+	if (scanManager->prefetchedUpTo < page + 1)
+		scanManager->prefetchedUpTo = page + 1;
+	if (end > scanManager->prefetchedUpTo)
+	{
+		RecordManager *recordManager = (RecordManager *)scan->rel->mgmtData;
+		if (scanManager->ring.mgmtData != NULL)
+			prefetchRingPages(recordManager->bufferPool, &scanManager->ring, scanManager->prefetchedUpTo, end - scanManager->prefetchedUpTo);
+		else
+			prefetchFilePages(recordManager->bufferPool, recordManager->fileId, scanManager->prefetchedUpTo, end - scanManager->prefetchedUpTo);
+		scanManager->prefetchedUpTo = end;
+	}
+}
+
+BM_ScanRing *AssignScanRing(RM_ScanHandle *scan)
+{
+	RM_ScanManager *scanManager = (RM_ScanManager *)scan->mgmtData;
+	return (scanManager->ring.mgmtData != NULL) ? &scanManager->ring : NULL;
+}
+
+PageNumber AssignCurrentPage(RM_ScanHandle *scan)
 {
-	int pg;
+	PageNumber pg;
 	pg = ((RM_ScanManager *)scan->mgmtData)->currentPage;
 	return pg;
 }
@@ -548,10 +760,10 @@ RID AssignCurrentRecordId(RM_ScanHandle *scan)
 	return id;
 }
 
-int AssignCurrentPageNext(RM_ScanHandle *scan)
+PageNumber AssignCurrentPageNext(RM_ScanHandle *scan)
 {
 	int one = 1;
-	int page;
+	PageNumber page;
 	page = ((RM_ScanManager *)scan->mgmtData)->currentPage + one;
 	return page;
 }
@@ -569,12 +781,13 @@ RC next(RM_ScanHandle *scan, Record *record)
 
 	if (expr == NULL)
 	{
-		while (rid.page < totalNumberOfPages && rid.page > zero)
+		while (rid.page < ((RecordManager *)scan->rel->mgmtData)->numPages && rid.page > zero)
 		{
 
 			Record *rd1 = ((RM_ScanManager *)scan->mgmtData)->currentRecord;
 			RM_TableData *rmTD1 = scan->rel;
-			getRecord(rmTD1, rid, rd1);
+			prefetchScanPages(scan, rid.page);
+			readRecord(rmTD1, rid, rd1, AssignScanRing(scan));
 			record->id = AssignCurrentRecordId(scan);
 			record->data = AssignCurrentRecordData(scan);
 			((RM_ScanManager *)scan->mgmtData)->currentPage = AssignCurrentPageNext(scan);
@@ -586,11 +799,12 @@ RC next(RM_ScanHandle *scan, Record *record)
 	else
 	{
 
-		while (rid.page < totalNumberOfPages && rid.page > zero)
+		while (rid.page < ((RecordManager *)scan->rel->mgmtData)->numPages && rid.page > zero)
 		{
 			Record *rd = ((RM_ScanManager *)scan->mgmtData)->currentRecord;
 			RM_TableData *rmTD = scan->rel;
-			getRecord(rmTD, rid, rd);
+			prefetchScanPages(scan, rid.page);
+			readRecord(rmTD, rid, rd, AssignScanRing(scan));
 			evalExpr(rd, rmTD->schema, expr, &result);
 			if (result->v.boolV && result->dt == DT_BOOL)
 			{
@@ -624,6 +838,9 @@ RM_ScanHandle *returnNullScan()
 
 RC closeScan(RM_ScanHandle *scan)
 {
+	RM_ScanManager *scanManager = (RM_ScanManager *)scan->mgmtData;
+	if (scanManager != NULL && scanManager->ring.mgmtData != NULL)
+		shutdownScanRing(((RecordManager *)scan->rel->mgmtData)->bufferPool, &scanManager->ring);
 	scan = returnNullScan();
 	free(scan);
 	return RC_OK;
@@ -730,12 +947,12 @@ RC createRecord(Record **rec, Schema *schema)
 {
 	printf("Create Record started\n");
 	int zero = 0;
-	size_t r = sizeof(Record);
 	*rec = createRecordObject();
 	int size = getRecordSize(schema);
 	(*rec)->data = (char *)malloc(size);
 	char *dt = (*rec)->data;
-	memset(dt, zero, r);
+	// clear the data area, its size is unrelated to sizeof(Record)
+	memset(dt, zero, size);
 	printf("Create Record ended\n");
 	return RC_OK;
 }
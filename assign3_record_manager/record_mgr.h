@@ -12,10 +12,17 @@ typedef struct RM_ScanHandle
 	void *mgmtData;
 } RM_ScanHandle;
 
+// How a scan reads the table's pages: through the whole buffer pool, or through a small ring of frames it recycles
+typedef enum RM_ScanMode {
+	RM_SCAN_NORMAL = 0,
+	RM_SCAN_BULK_READ = 1
+} RM_ScanMode;
+
 // table and manager
 extern RC initRecordManager (void *mgmtData);
 extern RC shutdownRecordManager ();
 extern RC createTable (char *name, Schema *schema);
+extern RC createTableWithPageSize (char *name, Schema *schema, int pageSize);
 extern RC openTable (RM_TableData *rel, char *name);
 extern RC closeTable (RM_TableData *rel);
 extern RC deleteTable (char *name);
@@ -29,8 +36,10 @@ extern RC getRecord (RM_TableData *rel, RID id, Record *record);
 
 // scans
 extern RC startScan (RM_TableData *rel, RM_ScanHandle *scan, Expr *cond);
+extern RC startScanWithMode (RM_TableData *rel, RM_ScanHandle *scan, Expr *cond, RM_ScanMode mode);
 extern RC next (RM_ScanHandle *scan, Record *record);
 extern RC closeScan (RM_ScanHandle *scan);
+extern RC setScanPrefetchDistance (RM_ScanHandle *scan, int distance);
 
 // dealing with schemas
 extern int getRecordSize (Schema *schema);
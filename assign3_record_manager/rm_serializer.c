@@ -160,7 +160,7 @@ char *serializeRecord(Record *record, Schema *schema)
 
 	int i;
 
-	APPEND(result, "[%i-%i] (", record->id.page, record->id.slot);
+	APPEND(result, "[%lld-%i] (", (long long)record->id.page, record->id.slot);
 
 	for (i = 0; i < schema->numAttr; i++)
 	{
@@ -314,7 +314,7 @@ char *createCharObject1()
 
 Record *createRecordObject1()
 {
-	return (Record *)malloc(sizeof(Record *));
+	return (Record *)malloc(sizeof(Record));
 }
 
 Schema *createSchemaObject1()
@@ -1,7 +1,71 @@
+#define _GNU_SOURCE
+#define _FILE_OFFSET_BITS 64
 #include "storage_mgr.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <errno.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <nmmintrin.h>
+#endif
+
+// completions the synchronous fallback of the async I/O engine can hold
+#define SM_SYNC_QUEUE_DEPTH 64
+
+// pages moved by one preadv/pwritev call of readBlocks/writeBlocks
+#define SM_MAX_RUN_PAGES 256
+
+// Management info kept behind SM_FileHandle->mgmtInfo. The descriptor stays open
+// for the lifetime of the handle and all block I/O is positional (pread/pwrite),
+// so no seek state is shared between callers. The header is cached here and only
+// written back when it has changed. In SM_IO_MMAP mode the whole file is mapped
+// and pages are copied in and out of the mapping. In SM_IO_DIRECT mode unaligned
+// caller buffers go through the aligned bounce page. The file is grown in extents:
+// allocatedBytes is the length of the file on disk, reservedBytes the part of it that is
+// really preallocated (the rest is sparse); the header keeps the logical page count.
+// Page I/O holds latch shared, so threads read and write pages in parallel; growing the
+// file (which may move the mapping) and the cached header take it exclusive. The async
+// engine is not latched, only one thread at a time may use it. unsynced tells syncPageFile
+// whether anything was written since the last sync.
+typedef struct SM_FileMgmt
+{
+	int fd;
+	SM_FileHeader header;
+	bool headerDirty;
+	bool unsynced;
+	SM_IOMode ioMode;
+	char *map;
+	size_t mapLength;
+	char *bounce;
+	off_t allocatedBytes;
+	off_t reservedBytes;
+	int extentPages;
+	int growthPercent;
+	int checksumErrors;
+	int pageSize;
+	struct SM_AsyncIO *async;
+	pthread_rwlock_t latch;
+	pthread_mutex_t bounceLatch;
+} SM_FileMgmt;
+
+void setCurrentPosition(int64_t pageNumber, SM_FileHandle *fHandle);
+
+// returns the descriptor of an opened file handle
+static int getFileDescriptor(SM_FileHandle *fHandle)
+{
+	return ((SM_FileMgmt *)fHandle->mgmtInfo)->fd;
+}
 
 /*
 //
@@ -15,20 +79,6 @@ void initStorageManager(void)
 	printf("CS525\n");
 }
 
-/*1. This method will assign values to management info and file seek
-2. Accepts sm_filehandle, filename and file values*/
-void assignFileHandle(SM_FileHandle *fHandle, char *fileName, FILE *file)
-{
-	fHandle->fileName = fileName;
-	int curPos = ftell(file) / PAGE_SIZE;
-	fHandle->curPagePos = curPos;
-	fseek(file, 0, SEEK_END);
-	int tnp = ftell(file) / PAGE_SIZE;
-	fHandle->totalNumPages = tnp;
-	fHandle->mgmtInfo = file;
-	fseek(file, curPos * PAGE_SIZE, SEEK_SET);
-}
-
 // This method is used to create empty page handles as per the page size
 SM_PageHandle getEmptyPageHandle()
 {
@@ -41,15 +91,388 @@ SM_PageHandle getEmptyPageHandle()
 	return page;
 }
 
-char *createCharObject()
+// allocates a zeroed page of pageSize bytes aligned for SM_IO_DIRECT; released with free
+char *createCharObject(int pageSize)
 {
-	char *page = (char *)calloc(PAGE_SIZE, sizeof(char));
-	return page;
+	void *page = NULL;
+	if (posix_memalign(&page, SM_IO_ALIGNMENT, pageSize) != 0)
+		return NULL;
+	memset(page, 0, pageSize);
+	return (char *)page;
+}
+
+// true for the page sizes a page file can be created with: powers of two from SM_MIN_PAGE_SIZE to SM_MAX_PAGE_SIZE
+bool isValidPageSize(long pageSize)
+{
+	return pageSize >= SM_MIN_PAGE_SIZE && pageSize <= SM_MAX_PAGE_SIZE && (pageSize & (pageSize - 1)) == 0;
+}
+
+// true if the buffer can be handed to O_DIRECT I/O as is
+bool isAlignedPage(char *page)
+{
+	return ((uintptr_t)page % SM_IO_ALIGNMENT) == 0;
+}
+
+// CRC32C (Castagnoli, reflected polynomial 0x82F63B78) lookup table for the portable path
+static uint32_t crc32cTable[256];
+
+// fills crc32cTable on first use
+static void initCRC32CTable(void)
+{
+	uint32_t i, bit, crc;
+	for (i = 0; i < 256; i++)
+	{
+		crc = i;
+		for (bit = 0; bit < 8; bit++)
+			crc = (crc & 1) ? (crc >> 1) ^ 0x82F63B78u : crc >> 1;
+		crc32cTable[i] = crc;
+	}
+}
+
+// table driven CRC32C, one byte per step
+static uint32_t crc32cPortable(uint32_t crc, const unsigned char *bytes, size_t length)
+{
+	if (crc32cTable[1] == 0)
+		initCRC32CTable();
+	while (length-- > 0)
+		crc = crc32cTable[(crc ^ *bytes++) & 0xFF] ^ (crc >> 8);
+	return crc;
+}
+
+// multiplies two polynomials modulo the CRC32C polynomial (bit-reflected representation)
+static uint32_t crc32cMultiply(uint32_t a, uint32_t b)
+{
+	uint32_t product = 0;
+	int bit;
+	for (bit = 0; bit < 32; bit++)
+	{
+		if (a & (0x80000000u >> bit))
+			product ^= b;
+		b = (b & 1) ? (b >> 1) ^ 0x82F63B78u : b >> 1;
+	}
+	return product;
+}
+
+// returns x^(8 * length) modulo the CRC32C polynomial, the factor that appends length zero bytes to a CRC
+static uint32_t crc32cZeroShift(size_t length)
+{
+	uint32_t crc = 0x80000000u;
+	if (crc32cTable[1] == 0)
+		initCRC32CTable();
+	while (length-- > 0)
+		crc = crc32cTable[crc & 0xFF] ^ (crc >> 8);
+	return crc;
+}
+
+#if defined(__x86_64__)
+// bytes per stream of the three way interleaved hardware CRC (multiple of 8)
+#define SM_CRC_STREAM_BYTES 1360
+
+// crc32 has a latency of three cycles but a throughput of one, so three independent streams
+// keep the unit busy; the partial CRCs are joined by multiplying with x^(8 * SM_CRC_STREAM_BYTES).
+// Always optimized, the Makefile builds without -O and this runs on every page read and write.
+__attribute__((target("sse4.2"), optimize("O2"))) static uint32_t crc32cHardware(uint32_t crc, const unsigned char *bytes, size_t length)
+{
+	static uint32_t streamShift = 0;
+	uint64_t crc64 = crc;
+	size_t i;
+	if (streamShift == 0)
+		streamShift = crc32cZeroShift(SM_CRC_STREAM_BYTES);
+	while (length >= 3 * SM_CRC_STREAM_BYTES)
+	{
+		uint64_t crcB = 0, crcC = 0, word;
+		for (i = 0; i < SM_CRC_STREAM_BYTES; i += 8)
+		{
+			memcpy(&word, bytes + i, sizeof(word));
+			crc64 = _mm_crc32_u64(crc64, word);
+			memcpy(&word, bytes + SM_CRC_STREAM_BYTES + i, sizeof(word));
+			crcB = _mm_crc32_u64(crcB, word);
+			memcpy(&word, bytes + 2 * SM_CRC_STREAM_BYTES + i, sizeof(word));
+			crcC = _mm_crc32_u64(crcC, word);
+		}
+		crc64 = crc32cMultiply(streamShift, (uint32_t)crc64) ^ (uint32_t)crcB;
+		crc64 = crc32cMultiply(streamShift, (uint32_t)crc64) ^ (uint32_t)crcC;
+		bytes += 3 * SM_CRC_STREAM_BYTES;
+		length -= 3 * SM_CRC_STREAM_BYTES;
+	}
+	while (length >= 8)
+	{
+		uint64_t word;
+		memcpy(&word, bytes, sizeof(word));
+		crc64 = _mm_crc32_u64(crc64, word);
+		bytes += 8;
+		length -= 8;
+	}
+	crc = (uint32_t)crc64;
+	while (length-- > 0)
+		crc = _mm_crc32_u8(crc, *bytes++);
+	return crc;
 }
+#endif
 
-void callFileWrite(char *page, FILE *file)
+/*
+1. This method returns the CRC32C of length bytes at data, continuing from crc (0 to start a new checksum)
+2. Uses the SSE4.2 crc32 instruction when the CPU has it and the lookup table otherwise
+*/
+uint32_t computeCRC32C(uint32_t crc, const void *data, size_t length)
+{
+	crc = ~crc;
+#if defined(__x86_64__)
+	if (__builtin_cpu_supports("sse4.2"))
+		crc = crc32cHardware(crc, data, length);
+	else
+#endif
+		crc = crc32cPortable(crc, data, length);
+	return ~crc;
+}
+
+// stores the checksum of the page data in the trailer (last bytes of the pageSize page) before the page is written
+void stampPageChecksum(char *page, int pageSize)
 {
-	fwrite(page, PAGE_SIZE, 1, file);
+	uint32_t crc = computeCRC32C(0, page, pageSize - SM_PAGE_TRAILER_SIZE);
+	memcpy(page + pageSize - SM_PAGE_TRAILER_SIZE, &crc, SM_PAGE_TRAILER_SIZE);
+}
+
+/*
+1. This method checks the trailer of a page that was just read
+2. A page that was never written (all zero, trailer included) is valid
+3. Returns RC_PAGE_CHECKSUM_MISMATCH and counts the error on the handle otherwise
+*/
+RC verifyPageChecksum(SM_FileMgmt *mgmt, char *page)
+{
+	uint32_t stored;
+	int dataSize = mgmt->pageSize - SM_PAGE_TRAILER_SIZE;
+	int i;
+	memcpy(&stored, page + dataSize, SM_PAGE_TRAILER_SIZE);
+	if (stored == computeCRC32C(0, page, dataSize))
+		return RC_OK;
+	for (i = 0; stored == 0 && i < dataSize && page[i] == 0; i++)
+		;
+	if (stored == 0 && i == dataSize)
+		return RC_OK;
+	__atomic_add_fetch(&mgmt->checksumErrors, 1, __ATOMIC_RELAXED);
+	return RC_PAGE_CHECKSUM_MISMATCH;
+}
+
+// writes one full page of pageSize bytes at the given byte offset of the file
+bool callFileWrite(char *page, int fd, off_t offset, int pageSize)
+{
+	return pwrite(fd, page, pageSize, offset) == pageSize;
+}
+
+/*
+1. This method makes sure at least length bytes of the file are reserved on disk
+2. Space is reserved with fallocate in extents of extentPages or growthPercent of the reserved space, whichever is larger
+3. On a large jump only the last extent is preallocated, the range before it is left sparse by ftruncate and does not count as reserved
+4. Falls back to ftruncate when the file system does not support fallocate
+*/
+RC reserveFileSpace(SM_FileMgmt *mgmt, off_t length)
+{
+	off_t extentBytes, newLength, start;
+	if (length <= mgmt->allocatedBytes)
+		return RC_OK;
+	extentBytes = (off_t)mgmt->extentPages * mgmt->pageSize;
+	if (mgmt->reservedBytes / 100 * mgmt->growthPercent > extentBytes)
+		extentBytes = mgmt->reservedBytes / 100 * mgmt->growthPercent;
+	newLength = mgmt->allocatedBytes + extentBytes;
+	if (newLength < length)
+		newLength = length;
+	// whole pages only, page offsets are counted from the header page
+	newLength = (newLength + mgmt->pageSize - 1) / mgmt->pageSize * mgmt->pageSize;
+	start = mgmt->allocatedBytes;
+	if (newLength - start > extentBytes)
+	{
+		if (ftruncate(mgmt->fd, newLength) != 0)
+			return RC_WRITE_FAILED;
+		start = (newLength - extentBytes) / mgmt->pageSize * mgmt->pageSize;
+	}
+	if (fallocate(mgmt->fd, 0, start, newLength - start) != 0)
+	{
+		if (errno != EOPNOTSUPP || ftruncate(mgmt->fd, newLength) != 0)
+			return RC_WRITE_FAILED;
+	}
+	mgmt->allocatedBytes = newLength;
+	mgmt->reservedBytes += newLength - start;
+	__atomic_store_n(&mgmt->unsynced, true, __ATOMIC_RELEASE);
+	return RC_OK;
+}
+
+/*
+1. This method makes the mapping of an SM_IO_MMAP file cover at least length bytes
+2. The file grows through reserveFileSpace and the mapping follows it to the whole allocated extent
+3. Returns RC_ERROR if the file cannot be extended or mapped
+*/
+RC growMapping(SM_FileMgmt *mgmt, size_t length)
+{
+	size_t newLength;
+	char *newMap;
+	if (length <= mgmt->mapLength)
+		return RC_OK;
+	if (reserveFileSpace(mgmt, (off_t)length) != RC_OK)
+		return RC_WRITE_FAILED;
+	newLength = (size_t)mgmt->allocatedBytes;
+	if (mgmt->map == NULL)
+		newMap = mmap(NULL, newLength, PROT_READ | PROT_WRITE, MAP_SHARED, mgmt->fd, 0);
+	else
+		newMap = mremap(mgmt->map, mgmt->mapLength, newLength, MREMAP_MAYMOVE);
+	if (newMap == MAP_FAILED)
+		return RC_ERROR;
+	mgmt->map = newMap;
+	mgmt->mapLength = newLength;
+	return RC_OK;
+}
+
+// reads one page at the given byte offset through the handle's I/O backend
+bool readPageAt(SM_FileMgmt *mgmt, char *page, off_t offset)
+{
+	if (mgmt->ioMode == SM_IO_MMAP)
+	{
+		if ((size_t)offset + mgmt->pageSize > mgmt->mapLength)
+			return false;
+		memcpy(page, mgmt->map + offset, mgmt->pageSize);
+		return true;
+	}
+	if (mgmt->ioMode == SM_IO_DIRECT && !isAlignedPage(page))
+	{
+		bool done;
+		pthread_mutex_lock(&mgmt->bounceLatch);
+		done = (pread(mgmt->fd, mgmt->bounce, mgmt->pageSize, offset) == mgmt->pageSize);
+		if (done)
+			memcpy(page, mgmt->bounce, mgmt->pageSize);
+		pthread_mutex_unlock(&mgmt->bounceLatch);
+		return done;
+	}
+	return pread(mgmt->fd, page, mgmt->pageSize, offset) == mgmt->pageSize;
+}
+
+// writes one page at the given byte offset through the handle's I/O backend
+bool writePageAt(SM_FileMgmt *mgmt, char *page, off_t offset)
+{
+	stampPageChecksum(page, mgmt->pageSize);
+	__atomic_store_n(&mgmt->unsynced, true, __ATOMIC_RELEASE);
+	if (mgmt->ioMode == SM_IO_MMAP)
+	{
+		if (growMapping(mgmt, (size_t)offset + mgmt->pageSize) != RC_OK)
+			return false;
+		memcpy(mgmt->map + offset, page, mgmt->pageSize);
+		return true;
+	}
+	if (mgmt->ioMode == SM_IO_DIRECT && !isAlignedPage(page))
+	{
+		bool done;
+		pthread_mutex_lock(&mgmt->bounceLatch);
+		memcpy(mgmt->bounce, page, mgmt->pageSize);
+		done = callFileWrite(mgmt->bounce, mgmt->fd, offset, mgmt->pageSize);
+		pthread_mutex_unlock(&mgmt->bounceLatch);
+		return done;
+	}
+	return callFileWrite(page, mgmt->fd, offset, mgmt->pageSize);
+}
+
+/*
+1. This method moves count adjacent pages starting at startPage between the file and pages[]
+2. Uses one preadv/pwritev per SM_MAX_RUN_PAGES pages; a short transfer is resumed at the first incomplete page
+3. SM_IO_MMAP copies page by page, unaligned buffers under SM_IO_DIRECT take the single page bounce path
+4. Page checksums are stamped before writing and verified after reading; all pages are read even if one fails
+*/
+RC transferPages(SM_FileMgmt *mgmt, int64_t startPage, int count, SM_PageHandle pages[], bool isWrite)
+{
+	struct iovec iov[SM_MAX_RUN_PAGES];
+	bool vectored = (mgmt->ioMode != SM_IO_MMAP);
+	RC returnCode = RC_OK;
+	int done = 0;
+	int i;
+	for (i = 0; vectored && mgmt->ioMode == SM_IO_DIRECT && i < count; i++)
+		vectored = isAlignedPage(pages[i]);
+	if (!vectored)
+	{
+		for (i = 0; i < count; i++)
+		{
+			off_t offset = (off_t)(startPage + i + 1) * mgmt->pageSize;
+			if (isWrite && !writePageAt(mgmt, pages[i], offset))
+				return RC_WRITE_FAILED;
+			if (!isWrite && !readPageAt(mgmt, pages[i], offset))
+				return RC_READ_FAILED;
+			if (!isWrite && verifyPageChecksum(mgmt, pages[i]) != RC_OK)
+				returnCode = RC_PAGE_CHECKSUM_MISMATCH;
+		}
+		return returnCode;
+	}
+	for (i = 0; isWrite && i < count; i++)
+		stampPageChecksum(pages[i], mgmt->pageSize);
+	if (isWrite)
+		__atomic_store_n(&mgmt->unsynced, true, __ATOMIC_RELEASE);
+	while (done < count)
+	{
+		int batch = count - done;
+		if (batch > SM_MAX_RUN_PAGES)
+			batch = SM_MAX_RUN_PAGES;
+		for (i = 0; i < batch; i++)
+		{
+			iov[i].iov_base = pages[done + i];
+			iov[i].iov_len = mgmt->pageSize;
+		}
+		off_t offset = (off_t)(startPage + done + 1) * mgmt->pageSize;
+		ssize_t result = isWrite ? pwritev(mgmt->fd, iov, batch, offset) : preadv(mgmt->fd, iov, batch, offset);
+		if (result < 0 && errno == EINTR)
+			continue;
+		if (result < mgmt->pageSize)
+			return isWrite ? RC_WRITE_FAILED : RC_READ_FAILED;
+		done += result / mgmt->pageSize;
+	}
+	for (i = 0; !isWrite && i < count; i++)
+		if (verifyPageChecksum(mgmt, pages[i]) != RC_OK)
+			returnCode = RC_PAGE_CHECKSUM_MISMATCH;
+	return returnCode;
+}
+
+// CRC32C over the header fields that precede the checksum
+uint32_t computeHeaderChecksum(SM_FileHeader *header)
+{
+	return computeCRC32C(0, header, offsetof(SM_FileHeader, checksum));
+}
+
+// fills a header for a newly created page file
+void initFileHeader(SM_FileHeader *header, int64_t totalNumPages, int pageSize)
+{
+	memset(header, 0, sizeof(SM_FileHeader));
+	header->magic = SM_FILE_MAGIC;
+	header->version = SM_FILE_VERSION;
+	header->pageSize = pageSize;
+	header->totalNumPages = totalNumPages;
+	header->freeListHead = SM_NO_FREE_PAGE;
+	header->tupleCount = 0;
+	header->schemaPage = 0;
+}
+
+// writes the header as the first bytes of an otherwise zeroed header page
+// (only the first SM_MIN_PAGE_SIZE bytes, which is all a header needs whatever the file's page size)
+bool writeHeaderPage(int fd, SM_FileHeader *header)
+{
+	bool written;
+	char *headerPage = createCharObject(SM_MIN_PAGE_SIZE);
+	header->checksum = computeHeaderChecksum(header);
+	memcpy(headerPage, header, sizeof(SM_FileHeader));
+	written = callFileWrite(headerPage, fd, 0, SM_MIN_PAGE_SIZE);
+	free(headerPage);
+	return written;
+}
+
+// reads and validates the header of an opened page file
+RC readHeaderPage(int fd, SM_FileHeader *header)
+{
+	// an aligned SM_MIN_PAGE_SIZE block is read so this also works with O_DIRECT, before the page size is known
+	char *headerPage = createCharObject(SM_MIN_PAGE_SIZE);
+	ssize_t resultOfRead = pread(fd, headerPage, SM_MIN_PAGE_SIZE, 0);
+	memcpy(header, headerPage, sizeof(SM_FileHeader));
+	free(headerPage);
+	if (resultOfRead != SM_MIN_PAGE_SIZE)
+		return RC_READ_FAILED;
+	if (header->magic != SM_FILE_MAGIC || header->checksum != computeHeaderChecksum(header))
+		return RC_INVALID_FILE_HEADER;
+	if (header->version != SM_FILE_VERSION || !isValidPageSize(header->pageSize))
+		return RC_UNSUPPORTED_FILE_VERSION;
+	return RC_OK;
 }
 
 /*
@@ -63,20 +486,31 @@ void callFileWrite(char *page, FILE *file)
 // Creating a page in the file
 RC createPageFile(char *fileName)
 {
-	char *firstPage;
-	char *headerPage;
-	FILE *file = fopen(fileName, "w");
-	if (file != NULL)
-	{
-		firstPage = createCharObject();
-		headerPage = createCharObject();
-		fputs("1", file);
-		callFileWrite(headerPage, file);
-		callFileWrite(firstPage, file);
-		free(headerPage);
-		free(firstPage);
-		fclose(file);
-		return RC_OK;
+	return createPageFileWithSize(fileName, PAGE_SIZE);
+}
+
+/*
+1. Creates a page file like createPageFile whose pages are pageSize bytes
+2. pageSize must be a power of two from SM_MIN_PAGE_SIZE to SM_MAX_PAGE_SIZE, otherwise RC_INVALID_PAGE_SIZE
+3. The page size is kept in the file header; every later open of the file uses it
+*/
+RC createPageFileWithSize(char *fileName, int pageSize)
+{
+	bool written;
+	char *emptyPage;
+	SM_FileHeader header;
+	if (!isValidPageSize(pageSize))
+		return RC_INVALID_PAGE_SIZE;
+	int fd = open(fileName, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (fd != -1)
+	{
+		emptyPage = createCharObject(pageSize);
+		initFileHeader(&header, 1, pageSize);
+		// header page followed by the first (empty) data page
+		written = writeHeaderPage(fd, &header) && callFileWrite(emptyPage, fd, pageSize, pageSize);
+		free(emptyPage);
+		close(fd);
+		return written ? RC_OK : RC_WRITE_FAILED;
 	}
 	else
 		return RC_FILE_NOT_FOUND;
@@ -99,25 +533,76 @@ bool checkValidfHandle(SM_FileHandle *fHandle)
 //openPageFile
 // 1. Opens existing file, else returns not found error
 // 2. Outputs properties of the file
-// 3. Writes using fputs
+// 3. The descriptor is kept open in the handle until closePageFile
+// 4. The binary header is read and validated once here
 */
 // open page function
 RC openPageFile(char *fileName, SM_FileHandle *fHandle)
+{
+	return openPageFileWithMode(fileName, fHandle, SM_IO_BUFFERED);
+}
+
+/*
+1. Opens an existing page file like openPageFile, using the given I/O backend
+2. SM_IO_MMAP maps the file (at least up to its last page) for the lifetime of the handle
+3. SM_IO_DIRECT opens the file with O_DIRECT; returns RC_DIRECT_IO_NOT_SUPPORTED if the file system refuses it
+*/
+RC openPageFileWithMode(char *fileName, SM_FileHandle *fHandle, SM_IOMode ioMode)
 {
 	int zero = 0;
 	if (!checkValidfHandle(fHandle))
 		return RC_FILE_HANDLE_NOT_INIT;
-	FILE *file = fopen(fileName, "r+");
-	if (file != NULL)
+	int fd = open(fileName, (ioMode == SM_IO_DIRECT) ? (O_RDWR | O_DIRECT) : O_RDWR);
+	if (fd == -1 && ioMode == SM_IO_DIRECT && errno == EINVAL)
+		return RC_DIRECT_IO_NOT_SUPPORTED;
+	if (fd != -1)
 	{
+		SM_FileMgmt *mgmt = (SM_FileMgmt *)malloc(sizeof(SM_FileMgmt));
+		RC readHeaderReturnCode = readHeaderPage(fd, &mgmt->header);
+		if (readHeaderReturnCode != RC_OK)
+		{
+			free(mgmt);
+			close(fd);
+			return readHeaderReturnCode;
+		}
+		mgmt->fd = fd;
+		mgmt->headerDirty = false;
+		mgmt->ioMode = ioMode;
+		mgmt->map = NULL;
+		mgmt->mapLength = 0;
+		mgmt->pageSize = mgmt->header.pageSize;
+		mgmt->bounce = (ioMode == SM_IO_DIRECT) ? createCharObject(mgmt->pageSize) : NULL;
+		mgmt->async = NULL;
+		mgmt->extentPages = SM_DEFAULT_EXTENT_PAGES;
+		mgmt->growthPercent = SM_DEFAULT_GROWTH_PERCENT;
+		mgmt->checksumErrors = 0;
+		pthread_rwlock_init(&mgmt->latch, NULL);
+		pthread_mutex_init(&mgmt->bounceLatch, NULL);
+		// earlier extents stay reserved past the last logical page
+		struct stat fileStat;
+		mgmt->allocatedBytes = (fstat(fd, &fileStat) == 0) ? fileStat.st_size : 0;
+		mgmt->reservedBytes = (mgmt->allocatedBytes > 0) ? (off_t)fileStat.st_blocks * 512 : 0;
+		if (mgmt->reservedBytes > mgmt->allocatedBytes)
+			mgmt->reservedBytes = mgmt->allocatedBytes;
+		if (ioMode == SM_IO_MMAP)
+		{
+			size_t length = (size_t)(mgmt->header.totalNumPages + 1) * mgmt->pageSize;
+			if ((off_t)length < mgmt->allocatedBytes)
+				length = mgmt->allocatedBytes;
+			if (growMapping(mgmt, length) != RC_OK)
+			{
+				pthread_rwlock_destroy(&mgmt->latch);
+				pthread_mutex_destroy(&mgmt->bounceLatch);
+				free(mgmt);
+				close(fd);
+				return RC_ERROR;
+			}
+		}
 		fHandle->fileName = fileName;
-		char *readHeader = createCharObject();
-		fgets(readHeader, PAGE_SIZE, file);
-		char *totalPage = readHeader;
-		fHandle->totalNumPages = atoi(totalPage);
+		fHandle->totalNumPages = mgmt->header.totalNumPages;
+		fHandle->pageSize = mgmt->pageSize;
 		fHandle->curPagePos = zero;
-		fHandle->mgmtInfo = file;
-		free(readHeader);
+		fHandle->mgmtInfo = mgmt;
 		return RC_OK;
 	}
 	else
@@ -152,9 +637,115 @@ RC closePageFile(SM_FileHandle *fHandle)
 		return RC_FILE_NOT_FOUND;
 	else
 	{
-		fclose(fHandle->mgmtInfo);
-		return RC_OK;
+		// in-flight asynchronous requests and pending header changes are finished before the descriptor is closed
+		shutdownAsyncIO(fHandle);
+		RC forceHeaderReturnCode = forceFileHeader(fHandle);
+		SM_FileMgmt *mgmt = fHandle->mgmtInfo;
+		if (mgmt->map != NULL)
+			munmap(mgmt->map, mgmt->mapLength);
+		free(mgmt->bounce);
+		pthread_rwlock_destroy(&mgmt->latch);
+		pthread_mutex_destroy(&mgmt->bounceLatch);
+		int result = close(getFileDescriptor(fHandle));
+		free(fHandle->mgmtInfo);
+		fHandle->mgmtInfo = NULL;
+		if (forceHeaderReturnCode != RC_OK)
+			return forceHeaderReturnCode;
+		return (result == 0) ? RC_OK : RC_ERROR;
+	}
+}
+
+/*
+1. This method copies the cached header of an opened page file into header
+2. The page count always reflects the handle
+*/
+RC getFileHeader(SM_FileHandle *fHandle, SM_FileHeader *header)
+{
+	if (!checkValidfHandle(fHandle))
+		return RC_FILE_HANDLE_NOT_INIT;
+	if (!checkValidMgmtInfo(fHandle))
+		return RC_FILE_NOT_FOUND;
+	SM_FileMgmt *mgmt = fHandle->mgmtInfo;
+	pthread_rwlock_wrlock(&mgmt->latch);
+	mgmt->header.totalNumPages = fHandle->totalNumPages;
+	memcpy(header, &mgmt->header, sizeof(SM_FileHeader));
+	pthread_rwlock_unlock(&mgmt->latch);
+	return RC_OK;
+}
+
+/*
+1. This method updates the metadata fields (free list head, tuple count, schema page) of the cached header
+2. The header is only marked dirty; it reaches the disk at the next forceFileHeader or closePageFile
+*/
+RC setFileHeader(SM_FileHandle *fHandle, SM_FileHeader *header)
+{
+	if (!checkValidfHandle(fHandle))
+		return RC_FILE_HANDLE_NOT_INIT;
+	if (!checkValidMgmtInfo(fHandle))
+		return RC_FILE_NOT_FOUND;
+	SM_FileMgmt *mgmt = fHandle->mgmtInfo;
+	pthread_rwlock_wrlock(&mgmt->latch);
+	mgmt->header.freeListHead = header->freeListHead;
+	mgmt->header.tupleCount = header->tupleCount;
+	mgmt->header.schemaPage = header->schemaPage;
+	mgmt->headerDirty = true;
+	pthread_rwlock_unlock(&mgmt->latch);
+	return RC_OK;
+}
+
+/*
+1. This method writes the cached header back to the header page if it has changed (checkpoint)
+2. Returns RC_WRITE_FAILED if the header page could not be written
+*/
+RC forceFileHeader(SM_FileHandle *fHandle)
+{
+	if (!checkValidfHandle(fHandle))
+		return RC_FILE_HANDLE_NOT_INIT;
+	if (!checkValidMgmtInfo(fHandle))
+		return RC_FILE_NOT_FOUND;
+	SM_FileMgmt *mgmt = fHandle->mgmtInfo;
+	RC returnCode = RC_OK;
+	pthread_rwlock_wrlock(&mgmt->latch);
+	if (mgmt->headerDirty)
+	{
+		mgmt->header.totalNumPages = fHandle->totalNumPages;
+		__atomic_store_n(&mgmt->unsynced, true, __ATOMIC_RELEASE);
+		if (writeHeaderPage(mgmt->fd, &mgmt->header))
+			mgmt->headerDirty = false;
+		else
+			returnCode = RC_WRITE_FAILED;
 	}
+	pthread_rwlock_unlock(&mgmt->latch);
+	return returnCode;
+}
+
+/*
+1. This method makes the pages and header written to the file so far durable, with one msync of the mapping for SM_IO_MMAP
+and one fdatasync otherwise
+2. A file nothing was written to since its last sync is left alone; writes during the sync are left to the next one
+3. Returns RC_WRITE_FAILED if the kernel reports a failed write-back, the file counts as not synced then
+*/
+RC syncPageFile(SM_FileHandle *fHandle)
+{
+	if (!checkValidfHandle(fHandle))
+		return RC_FILE_HANDLE_NOT_INIT;
+	if (!checkValidMgmtInfo(fHandle))
+		return RC_FILE_NOT_FOUND;
+	SM_FileMgmt *mgmt = fHandle->mgmtInfo;
+	int result;
+	if (!__atomic_exchange_n(&mgmt->unsynced, false, __ATOMIC_ACQ_REL))
+		return RC_OK;
+	// the mapping moves only under the exclusive latch
+	pthread_rwlock_rdlock(&mgmt->latch);
+	if (mgmt->map != NULL)
+		result = msync(mgmt->map, mgmt->mapLength, MS_SYNC);
+	else
+		result = fdatasync(mgmt->fd);
+	pthread_rwlock_unlock(&mgmt->latch);
+	if (result == 0)
+		return RC_OK;
+	__atomic_store_n(&mgmt->unsynced, true, __ATOMIC_RELEASE);
+	return RC_WRITE_FAILED;
 }
 
 // destroying the page file
@@ -169,65 +760,98 @@ RC destroyPageFile(char *fileName)
 /*
 // Writes from memory into disk to an absolute location using the given pageNum.
 // Darek Nowak A20497998
-// 1. Opens file
-// 2. Fseeks given the offset from memPage to find the absolute location of where we will write
-// 3. Writes using fwrite
+// 1. Computes the absolute location of the page from pageNum (page 0 follows the header page)
+// 2. Writes the page there using pwrite
 */
-RC writeBlock(int pageNum, SM_FileHandle *fHandle, SM_PageHandle memPage)
+RC writeBlock(int64_t pageNum, SM_FileHandle *fHandle, SM_PageHandle memPage)
 {
 	if (!checkValidfHandle(fHandle))
 		return RC_FILE_HANDLE_NOT_INIT;
 	if (!checkValidMgmtInfo(fHandle))
 		return RC_FILE_NOT_FOUND;
-	int pn = pageNum + 1;
-	if (pageNum < fHandle->totalNumPages)
-	{
-		fseek(fHandle->mgmtInfo, (pn * PAGE_SIZE), SEEK_SET);
-		fwrite(memPage, PAGE_SIZE, 1, fHandle->mgmtInfo);
-		// Updates current page number to recently written file.
-		fHandle->curPagePos = pageNum;
-	}
-	else
+	SM_FileMgmt *mgmt = fHandle->mgmtInfo;
+	int64_t pn = pageNum + 1;
+	bool written = false;
+	pthread_rwlock_rdlock(&mgmt->latch);
+	if (pageNum >= 0 && pageNum < fHandle->totalNumPages)
+		written = writePageAt(mgmt, memPage, (off_t)pn * fHandle->pageSize);
+	pthread_rwlock_unlock(&mgmt->latch);
+	if (!written)
 		return RC_WRITE_FAILED;
+	// Updates current page number to recently written file.
+	setCurrentPosition(pageNum, fHandle);
+	return RC_OK;
+}
+
+/*
+1. Writes count adjacent pages, pages[0] going to startPage, with vectored writes
+2. All pages must already exist; the current page position ends at the last page written
+*/
+RC writeBlocks(int64_t startPage, int count, SM_FileHandle *fHandle, SM_PageHandle pages[])
+{
+	if (!checkValidfHandle(fHandle))
+		return RC_FILE_HANDLE_NOT_INIT;
+	if (!checkValidMgmtInfo(fHandle))
+		return RC_FILE_NOT_FOUND;
+	SM_FileMgmt *mgmt = fHandle->mgmtInfo;
+	RC transferReturnCode = RC_WRITE_FAILED;
+	pthread_rwlock_rdlock(&mgmt->latch);
+	if (startPage >= 0 && count > 0 && startPage + count <= fHandle->totalNumPages)
+		transferReturnCode = transferPages(mgmt, startPage, count, pages, true);
+	pthread_rwlock_unlock(&mgmt->latch);
+	if (transferReturnCode != RC_OK)
+		return transferReturnCode;
+	setCurrentPosition(startPage + count - 1, fHandle);
 	return RC_OK;
 }
 
 /*
 // Darek Nowak A20497998
-// Writes from memory into disk to where the page handle pointer is currently pointing at. Same as writeblock, just that there is no need to seek.
-// 1. Opens file
-// 2. Write using fwrite
+// Writes from memory into disk to where the page handle pointer is currently pointing at. Same as writeblock, using the current page position.
+// 1. Checks the current page exists
+// 2. Write using writeBlock
 */
 RC writeCurrentBlock(SM_FileHandle *fHandle, SM_PageHandle memPage)
 {
-	// If the page you're looking for exists, seek to the page and write.
+	// If the page you're looking for exists, write it at the current position.
 	if (fHandle->curPagePos < fHandle->totalNumPages)
 	{
-		fwrite(memPage, PAGE_SIZE, 1, fHandle->mgmtInfo);
+		return writeBlock(fHandle->curPagePos, fHandle, memPage);
 	}
 	else
 	{
 		return RC_READ_NON_EXISTING_PAGE;
 	}
-	return RC_OK;
 }
-
-// This method performs the file seek and write on the opened file and finally closes it
-void fileSeekOperation(SM_PageHandle emptyPage, char *fn)
+/*
+1. This method makes the file hold numberOfPages logical pages
+2. Disk space comes from reserveFileSpace (a whole extent at a time); reserved space past the old end is already zero
+3. With SM_IO_MMAP the mapping grows with the file
+4. Only the cached header is updated, it is marked dirty and written back lazily
+5. The caller holds the handle's latch exclusively
+*/
+RC growFile(SM_FileHandle *fHandle, int64_t numberOfPages)
 {
-	FILE *fileInAppendMode = fopen(fn, "r+");
-	fseek(fileInAppendMode, 0, SEEK_END);
-	fwrite(emptyPage, PAGE_SIZE, 1, fileInAppendMode);
-	fseek(fileInAppendMode, 0, SEEK_END);
-	fclose(fileInAppendMode);
+	SM_FileMgmt *mgmt = fHandle->mgmtInfo;
+	off_t length = (off_t)(numberOfPages + 1) * mgmt->pageSize;
+	RC returnCode;
+	if (mgmt->ioMode == SM_IO_MMAP)
+		returnCode = growMapping(mgmt, (size_t)length);
+	else
+		returnCode = reserveFileSpace(mgmt, length);
+	if (returnCode != RC_OK)
+		return RC_WRITE_FAILED;
+	// ensureCapacity peeks at the page count without the latch
+	__atomic_store_n(&fHandle->totalNumPages, numberOfPages, __ATOMIC_RELEASE);
+	mgmt->headerDirty = true;
+	return RC_OK;
 }
+
 /*
 // Darek Nowak A20497998
-// Increment number of pages(blocks) by 1 and create a file filled with PAGE_SIZE amount of 0 chars.
-// 1. Create new page via a new char* to newBlock
-// 2. Iterate through the page until you fill it with 4096 0 chars.
-// 3. Update the metadata by incrementing totalNumPages
-// 4. Use the writeBlock function to write a new file with the given newBlock.
+// Increment number of pages(blocks) by 1 and make the new page read back as a page of 0 chars.
+// 1. Grow the file by one page, reserving a whole extent when the reserved space runs out
+// 2. Update the metadata by incrementing totalNumPages; the header is only marked dirty
 */
 RC appendEmptyBlock(SM_FileHandle *fHandle)
 {
@@ -237,96 +861,104 @@ RC appendEmptyBlock(SM_FileHandle *fHandle)
 		return RC_FILE_NOT_FOUND;
 
 	int one = 1;
-	int tnp = fHandle->totalNumPages;
-	int page = tnp + one;
-	char *pg = createCharObject();
-	fseek(fHandle->mgmtInfo, page * PAGE_SIZE, SEEK_SET);
-	if (fwrite(pg, PAGE_SIZE, 1, fHandle->mgmtInfo))
-	{
-		fHandle->totalNumPages = fHandle->totalNumPages + one;
-		fHandle->curPagePos = fHandle->totalNumPages - one;
-		fseek(fHandle->mgmtInfo, 0L, SEEK_SET);
-		fprintf(fHandle->mgmtInfo, "%d", fHandle->totalNumPages);
-		int tnp1 = fHandle->totalNumPages;
-		int page1 = tnp + one;
-		fseek(fHandle->mgmtInfo, page1 * PAGE_SIZE, SEEK_SET);
-		free(pg);
-		return RC_OK;
-	}
-	else
-	{
-		free(pg);
-		return RC_WRITE_FAILED;
-	}
+	SM_FileMgmt *mgmt = fHandle->mgmtInfo;
+	int64_t newPage;
+	pthread_rwlock_wrlock(&mgmt->latch);
+	newPage = fHandle->totalNumPages;
+	RC growReturnCode = growFile(fHandle, newPage + one);
+	pthread_rwlock_unlock(&mgmt->latch);
+	if (growReturnCode == RC_OK)
+		setCurrentPosition(newPage, fHandle);
+	return growReturnCode;
 }
 
 /*
 // Darek Nowak A20497998
 // If # of pages in memory is different than # of pages in disk, increase size of pages and update metadata.
 // 1. Check to see if there is a difference in pages with memory and disk.
-// 2. If there are more pages in memory, then write to the disk 1 empty file.
+// 2. If there are more pages in memory, grow the file to that many pages in one step.
 */
-RC ensureCapacity(int numberOfPages, SM_FileHandle *fHandle)
+RC ensureCapacity(int64_t numberOfPages, SM_FileHandle *fHandle)
 {
-	int totalPage = fHandle->totalNumPages;
-	// pages in memory differs from pages in disk
-	if (numberOfPages > totalPage)
-	{
-		// create pages until # of pages in memory and disk equal
-		while (numberOfPages > fHandle->totalNumPages)
-		{
-			appendEmptyBlock(fHandle);
-		}
-		return RC_OK;
-	}
-	else
-	{
-		// Pages in memory = pages in disk
+	if (!checkValidfHandle(fHandle))
+		return RC_FILE_HANDLE_NOT_INIT;
+	if (!checkValidMgmtInfo(fHandle))
+		return RC_FILE_NOT_FOUND;
+	SM_FileMgmt *mgmt = fHandle->mgmtInfo;
+	RC growReturnCode = RC_OK;
+	int64_t totalPage = __atomic_load_n(&fHandle->totalNumPages, __ATOMIC_ACQUIRE);
+	// Pages in memory = pages in disk, the common case needs no latch
+	if (numberOfPages <= totalPage)
 		return RC_OK;
-	}
+	pthread_rwlock_wrlock(&mgmt->latch);
+	// pages in memory differs from pages in disk, unless another thread grew the file meanwhile
+	if (numberOfPages > fHandle->totalNumPages)
+		growReturnCode = growFile(fHandle, numberOfPages);
+	pthread_rwlock_unlock(&mgmt->latch);
+	return growReturnCode;
 }
 
 /*
-Ramya Krishnan(rkrishnan1@hawk.iit.edu) - A20506653
-1. This method checks if the given page number is valid
-2. Checks if page number is less than zero and it is a valid page number
-3. If yes, it will return false
-4. If no, it will retrun true
+1. This method sets how the file grows once its reserved space is used up
+2. Each growth reserves at least extentPages pages and at least growthPercent of the current allocation
 */
-bool checkValidPageNumber(int pageNum, int totalNumberOfPagesInTheFile)
+RC setFileGrowth(SM_FileHandle *fHandle, int extentPages, int growthPercent)
 {
-	return ((pageNum < 0) & (pageNum > totalNumberOfPagesInTheFile)) ? false : true;
+	if (!checkValidfHandle(fHandle))
+		return RC_FILE_HANDLE_NOT_INIT;
+	if (!checkValidMgmtInfo(fHandle))
+		return RC_FILE_NOT_FOUND;
+	SM_FileMgmt *mgmt = fHandle->mgmtInfo;
+	pthread_rwlock_wrlock(&mgmt->latch);
+	mgmt->extentPages = (extentPages > 0) ? extentPages : 1;
+	mgmt->growthPercent = (growthPercent > 0) ? growthPercent : 0;
+	pthread_rwlock_unlock(&mgmt->latch);
+	return RC_OK;
 }
 
-/*
-Ramya Krishnan(rkrishnan1@hawk.iit.edu) - A20506653
-1. This method checks if the result of the fseek is valid
-2. If seek result is not zero, return false
-3. If seek result is zero, return true
-*/
-bool checkValidSeek(int resultOfseek)
+// returns the number of data pages the file has room for on disk, at least totalNumPages
+int64_t getAllocatedPages(SM_FileHandle *fHandle)
 {
-	return (resultOfseek > 0 || resultOfseek < 0) ? false : true;
+	if (!checkValidfHandle(fHandle) || !checkValidMgmtInfo(fHandle))
+		return -1;
+	SM_FileMgmt *mgmt = fHandle->mgmtInfo;
+	pthread_rwlock_rdlock(&mgmt->latch);
+	int64_t allocated = mgmt->allocatedBytes / mgmt->pageSize - 1;
+	if (allocated < fHandle->totalNumPages)
+		allocated = fHandle->totalNumPages;
+	pthread_rwlock_unlock(&mgmt->latch);
+	return allocated;
+}
+
+// returns how many pages read through the handle failed checksum verification since it was opened
+int getNumPageChecksumErrors(SM_FileHandle *fHandle)
+{
+	if (!checkValidfHandle(fHandle) || !checkValidMgmtInfo(fHandle))
+		return 0;
+	return __atomic_load_n(&((SM_FileMgmt *)fHandle->mgmtInfo)->checksumErrors, __ATOMIC_RELAXED);
 }
 
 /*
 Ramya Krishnan(rkrishnan1@hawk.iit.edu) - A20506653
-1. This method checks if the result of the fseek is valid
-2. If page size and the fread result is equal, return true
-3. If page size and the fread result is not equal, return false
+1. This method checks if the given page number is valid
+2. Checks if page number is less than zero and it is a valid page number
+3. If yes, it will return false
+4. If no, it will retrun true
 */
-bool checkValidRead(int resultOfRead)
+bool checkValidPageNumber(int64_t pageNum, int64_t totalNumberOfPagesInTheFile)
 {
-	return (PAGE_SIZE == resultOfRead) ? true : false;
+	// pages past the last one may already be allocated on disk (extents), so they are rejected here
+	return ((pageNum < 0) || (pageNum >= totalNumberOfPagesInTheFile)) ? false : true;
 }
 
 /*
 Ramya Krishnan(rkrishnan1@hawk.iit.edu) - A20506653
 This method sets the pagenumber to the current page position in the Handler property
 */
-void setCurrentPosition(int pageNumber, SM_FileHandle *fHandle)
+void setCurrentPosition(int64_t pageNumber, SM_FileHandle *fHandle)
 {
-	fHandle->curPagePos = pageNumber;
+	// threads sharing the handle each set it, the last one wins
+	__atomic_store_n(&fHandle->curPagePos, pageNumber, __ATOMIC_RELAXED);
 }
 
 /*
@@ -335,37 +967,64 @@ Ramya Krishnan(rkrishnan1@hawk.iit.edu) - A20506653
 2. Inputs- page number which needs to be retrieved, fileHandle and pageHandle
 3. returns - Returns code as per the result
 */
-RC readBlock(int pageNum, SM_FileHandle *fHandle, SM_PageHandle memPage)
+RC readBlock(int64_t pageNum, SM_FileHandle *fHandle, SM_PageHandle memPage)
 {
-	int resultOfSeek, resultOfRead, totalNumberOfPagesInTheFile;
-	totalNumberOfPagesInTheFile = fHandle->totalNumPages;
+	bool pageRead;
+	int64_t totalNumberOfPagesInTheFile;
 	// Checks if the fhandle is valid and returns error code if its not initialized
 	if (!checkValidfHandle(fHandle))
 		return RC_FILE_HANDLE_NOT_INIT;
 
-	// Checks if the input page number is valid and returns error code if its not exist
-	if (!checkValidPageNumber(pageNum, totalNumberOfPagesInTheFile))
-		return RC_READ_NON_EXISTING_PAGE;
-
 	// Checks if the management info is valid and returns error code if its not exist
 	if (!checkValidMgmtInfo(fHandle))
 		return RC_FILE_NOT_FOUND;
-	int increPageNum = pageNum + 1;
-	// File seek is performed on the file with page number and returns error if the seek result is not valid
-	resultOfSeek = fseek(fHandle->mgmtInfo, increPageNum * PAGE_SIZE, SEEK_SET);
-	if (!checkValidSeek)
-		return RC_ERROR;
+	SM_FileMgmt *mgmt = fHandle->mgmtInfo;
+	pthread_rwlock_rdlock(&mgmt->latch);
+	totalNumberOfPagesInTheFile = fHandle->totalNumPages;
 
-	// File read is performed on the file with page number and loaded into the memory. This returns error if the seek result is not valid
-	resultOfRead = fread(memPage, sizeof(char), PAGE_SIZE, fHandle->mgmtInfo);
-	if (!checkValidRead(resultOfRead))
+	// Checks if the input page number is valid and returns error code if its not exist
+	if (!checkValidPageNumber(pageNum, totalNumberOfPagesInTheFile))
+	{
+		pthread_rwlock_unlock(&mgmt->latch);
+		return RC_READ_NON_EXISTING_PAGE;
+	}
+	int64_t increPageNum = pageNum + 1;
+	// Positional read of the page (page 0 follows the header page) into the memory. This returns error if the read is short
+	pageRead = readPageAt(mgmt, memPage, (off_t)increPageNum * fHandle->pageSize);
+	pthread_rwlock_unlock(&mgmt->latch);
+	if (!pageRead)
 		return RC_READ_FAILED;
+	// the page is handed back even when its trailer does not match, the caller decides what to do with it
+	RC checksumReturnCode = verifyPageChecksum(fHandle->mgmtInfo, memPage);
 
 	// Sets the page number to the current page postion in fHandle
 	setCurrentPosition(pageNum, fHandle);
 
-	// return RC_OK code if the able to read the file without any exception
-	return RC_OK;
+	// return RC_OK code if the able to read the file without any exception, RC_PAGE_CHECKSUM_MISMATCH for a corrupted page
+	return checksumReturnCode;
+}
+
+/*
+1. This method reads count adjacent pages starting at startPage into pages[] with vectored reads
+2. Returns RC_READ_NON_EXISTING_PAGE if the run goes past the last page
+3. Returns RC_PAGE_CHECKSUM_MISMATCH if any page of the run is corrupted, the other pages are still read
+*/
+RC readBlocks(int64_t startPage, int count, SM_FileHandle *fHandle, SM_PageHandle pages[])
+{
+	if (!checkValidfHandle(fHandle))
+		return RC_FILE_HANDLE_NOT_INIT;
+	if (!checkValidMgmtInfo(fHandle))
+		return RC_FILE_NOT_FOUND;
+	SM_FileMgmt *mgmt = fHandle->mgmtInfo;
+	RC transferReturnCode = RC_READ_NON_EXISTING_PAGE;
+	pthread_rwlock_rdlock(&mgmt->latch);
+	if (startPage >= 0 && count > 0 && startPage + count <= fHandle->totalNumPages)
+		transferReturnCode = transferPages(mgmt, startPage, count, pages, false);
+	pthread_rwlock_unlock(&mgmt->latch);
+	if (transferReturnCode != RC_OK && transferReturnCode != RC_PAGE_CHECKSUM_MISMATCH)
+		return transferReturnCode;
+	setCurrentPosition(startPage + count - 1, fHandle);
+	return transferReturnCode;
 }
 
 /*
@@ -374,7 +1033,7 @@ Ramya Krishnan(rkrishnan1@hawk.iit.edu) - A20506653
 2. Inputs- page number which needs to be retrieved, fileHandle and pageHandle
 3. returns the current page position if no exception
 */
-int getBlockPos(SM_FileHandle *fHandle)
+int64_t getBlockPos(SM_FileHandle *fHandle)
 {
 	if (checkValidfHandle(fHandle))
 	{
@@ -422,7 +1081,7 @@ Ramya Krishnan(rkrishnan1@hawk.iit.edu) - A20506653
 */
 RC readPreviousBlock(SM_FileHandle *fHandle, SM_PageHandle memPage)
 {
-	int currentPosValue = getBlockPos(fHandle);
+	int64_t currentPosValue = getBlockPos(fHandle);
 
 	// Previous page postion is sent to the readblock and read into the memory page
 	return readBlock(currentPosValue - 1, fHandle, memPage);
@@ -436,7 +1095,7 @@ Ramya Krishnan(rkrishnan1@hawk.iit.edu) - A20506653
 */
 RC readCurrentBlock(SM_FileHandle *fHandle, SM_PageHandle memPage)
 {
-	int currentPosValue = getBlockPos(fHandle);
+	int64_t currentPosValue = getBlockPos(fHandle);
 
 	// gets the current position using getBlockPos method and sent tot he readblock to load the current page to the memory
 	return readBlock(currentPosValue, fHandle, memPage);
@@ -450,7 +1109,7 @@ Ramya Krishnan(rkrishnan1@hawk.iit.edu) - A20506653
 */
 RC readNextBlock(SM_FileHandle *fHandle, SM_PageHandle memPage)
 {
-	int currentPosValue = getBlockPos(fHandle);
+	int64_t currentPosValue = getBlockPos(fHandle);
 
 	// gets the current page position using getBlockPos method and added one to read the next page to the memory
 	return readBlock(currentPosValue + 1, fHandle, memPage);
@@ -464,7 +1123,7 @@ Ramya Krishnan(rkrishnan1@hawk.iit.edu) - A20506653
 */
 RC readLastBlock(SM_FileHandle *fHandle, SM_PageHandle memPage)
 {
-	int lastPageNumber;
+	int64_t lastPageNumber;
 
 	// gets the total number of page from the file handle
 	lastPageNumber = fHandle->totalNumPages;
@@ -472,3 +1131,311 @@ RC readLastBlock(SM_FileHandle *fHandle, SM_PageHandle memPage)
 	// reads the last page position in the file and loads into the memory
 	return readBlock(lastPageNumber - 1, fHandle, memPage);
 }
+
+/************************************************************
+ *                asynchronous page I/O engine              *
+ ************************************************************/
+
+// One slot per request that has been submitted and not yet completed
+typedef struct SM_AsyncRequest
+{
+	void *tag;
+	char *page;
+	bool inUse;
+	bool isWrite;
+} SM_AsyncRequest;
+
+// Asynchronous I/O engine of a file handle. With a ring, requests are queued as
+// io_uring SQEs and handed to the kernel by completeBlocks. Without one (ringFd == -1)
+// each request is performed at submit time and its completion kept in ready.
+typedef struct SM_AsyncIO
+{
+	int ringFd;
+	int queueDepth;
+	SM_AsyncRequest *requests;
+	int numQueued;
+	int numInFlight;
+	SM_IOCompletion *ready;
+	int numReady;
+	void *sqRing;
+	size_t sqRingSize;
+	void *cqRing;
+	size_t cqRingSize;
+	struct io_uring_sqe *sqes;
+	size_t sqesSize;
+	unsigned *sqTail;
+	unsigned *sqMask;
+	unsigned *sqArray;
+	unsigned *cqHead;
+	unsigned *cqTail;
+	unsigned *cqMask;
+	struct io_uring_cqe *cqes;
+} SM_AsyncIO;
+
+// returns the engine of an opened file handle, NULL if initAsyncIO was not called
+SM_AsyncIO *getAsyncIO(SM_FileHandle *fHandle)
+{
+	if (!checkValidfHandle(fHandle) || !checkValidMgmtInfo(fHandle))
+		return NULL;
+	return ((SM_FileMgmt *)fHandle->mgmtInfo)->async;
+}
+
+/*
+1. This method creates the io_uring instance and maps its submission and completion rings
+2. Returns false (leaving ringFd at -1) if the kernel refuses, e.g. no io_uring support or a seccomp filter
+*/
+bool createRing(SM_AsyncIO *aio)
+{
+	struct io_uring_params params;
+	memset(&params, 0, sizeof(params));
+	int ringFd = syscall(__NR_io_uring_setup, aio->queueDepth, &params);
+	if (ringFd < 0)
+		return false;
+
+	aio->sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+	aio->cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+	if (params.features & IORING_FEAT_SINGLE_MMAP)
+	{
+		if (aio->cqRingSize > aio->sqRingSize)
+			aio->sqRingSize = aio->cqRingSize;
+		aio->cqRingSize = aio->sqRingSize;
+	}
+	aio->sqRing = mmap(NULL, aio->sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQ_RING);
+	if (aio->sqRing == MAP_FAILED)
+	{
+		close(ringFd);
+		return false;
+	}
+	if (params.features & IORING_FEAT_SINGLE_MMAP)
+		aio->cqRing = aio->sqRing;
+	else
+		aio->cqRing = mmap(NULL, aio->cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_CQ_RING);
+	aio->sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+	aio->sqes = mmap(NULL, aio->sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES);
+	if (aio->cqRing == MAP_FAILED || aio->sqes == MAP_FAILED)
+	{
+		if (aio->cqRing != MAP_FAILED && aio->cqRing != aio->sqRing)
+			munmap(aio->cqRing, aio->cqRingSize);
+		if (aio->sqes != MAP_FAILED)
+			munmap(aio->sqes, aio->sqesSize);
+		munmap(aio->sqRing, aio->sqRingSize);
+		close(ringFd);
+		return false;
+	}
+
+	char *sq = aio->sqRing;
+	char *cq = aio->cqRing;
+	aio->sqTail = (unsigned *)(sq + params.sq_off.tail);
+	aio->sqMask = (unsigned *)(sq + params.sq_off.ring_mask);
+	aio->sqArray = (unsigned *)(sq + params.sq_off.array);
+	aio->cqHead = (unsigned *)(cq + params.cq_off.head);
+	aio->cqTail = (unsigned *)(cq + params.cq_off.tail);
+	aio->cqMask = (unsigned *)(cq + params.cq_off.ring_mask);
+	aio->cqes = (struct io_uring_cqe *)(cq + params.cq_off.cqes);
+	aio->ringFd = ringFd;
+	return true;
+}
+
+/*
+1. This method sets up the asynchronous engine of an opened file handle
+2. queueDepth is the number of requests that may be in flight; queueDepth <= 0 selects the synchronous fallback
+3. The synchronous fallback is also used when no io_uring instance can be created or the file is memory mapped
+*/
+RC initAsyncIO(SM_FileHandle *fHandle, int queueDepth)
+{
+	if (!checkValidfHandle(fHandle))
+		return RC_FILE_HANDLE_NOT_INIT;
+	if (!checkValidMgmtInfo(fHandle))
+		return RC_FILE_NOT_FOUND;
+	SM_FileMgmt *mgmt = fHandle->mgmtInfo;
+	if (mgmt->async != NULL)
+		return RC_OK;
+
+	SM_AsyncIO *aio = (SM_AsyncIO *)calloc(1, sizeof(SM_AsyncIO));
+	bool useRing = (queueDepth > 0 && mgmt->ioMode != SM_IO_MMAP);
+	aio->ringFd = -1;
+	aio->queueDepth = (queueDepth > 0) ? queueDepth : SM_SYNC_QUEUE_DEPTH;
+	if (useRing)
+		createRing(aio);
+	aio->requests = (SM_AsyncRequest *)calloc(aio->queueDepth, sizeof(SM_AsyncRequest));
+	aio->ready = (SM_IOCompletion *)calloc(aio->queueDepth, sizeof(SM_IOCompletion));
+	mgmt->async = aio;
+	return RC_OK;
+}
+
+/*
+1. This method waits for all requests still in flight and releases the engine
+2. Completions that were never collected are dropped
+*/
+RC shutdownAsyncIO(SM_FileHandle *fHandle)
+{
+	SM_AsyncIO *aio = getAsyncIO(fHandle);
+	if (aio == NULL)
+		return RC_OK;
+	SM_IOCompletion completion;
+	int numCompleted;
+	while (aio->numInFlight > 0)
+	{
+		if (completeBlocks(fHandle, 1, &completion, 1, &numCompleted) != RC_OK)
+			break;
+	}
+	if (aio->ringFd != -1)
+	{
+		munmap(aio->sqes, aio->sqesSize);
+		if (aio->cqRing != aio->sqRing)
+			munmap(aio->cqRing, aio->cqRingSize);
+		munmap(aio->sqRing, aio->sqRingSize);
+		close(aio->ringFd);
+	}
+	free(aio->requests);
+	free(aio->ready);
+	free(aio);
+	((SM_FileMgmt *)fHandle->mgmtInfo)->async = NULL;
+	return RC_OK;
+}
+
+/*
+1. This method queues one page read or write on the engine of fHandle
+2. With a ring the request becomes an SQE that completeBlocks submits; otherwise it is performed right away
+3. Returns RC_ASYNC_IO_QUEUE_FULL when queueDepth requests are already outstanding
+*/
+RC submitBlock(int64_t pageNum, SM_FileHandle *fHandle, SM_PageHandle memPage, void *tag, bool isWrite)
+{
+	SM_AsyncIO *aio = getAsyncIO(fHandle);
+	if (aio == NULL)
+		return checkValidfHandle(fHandle) ? RC_FILE_NOT_FOUND : RC_FILE_HANDLE_NOT_INIT;
+	if (aio->numInFlight + aio->numReady >= aio->queueDepth)
+		return RC_ASYNC_IO_QUEUE_FULL;
+
+	SM_FileMgmt *mgmt = fHandle->mgmtInfo;
+	off_t offset = (off_t)(pageNum + 1) * mgmt->pageSize;
+	pthread_rwlock_rdlock(&mgmt->latch);
+	if (pageNum < 0 || pageNum >= fHandle->totalNumPages)
+	{
+		pthread_rwlock_unlock(&mgmt->latch);
+		return isWrite ? RC_WRITE_FAILED : RC_READ_NON_EXISTING_PAGE;
+	}
+	// O_DIRECT needs aligned buffers; unaligned ones use the synchronous bounce path
+	bool useRing = (aio->ringFd != -1) && (mgmt->ioMode != SM_IO_DIRECT || isAlignedPage(memPage));
+	if (!useRing)
+	{
+		bool done = isWrite ? writePageAt(mgmt, memPage, offset) : readPageAt(mgmt, memPage, offset);
+		pthread_rwlock_unlock(&mgmt->latch);
+		aio->ready[aio->numReady].tag = tag;
+		aio->ready[aio->numReady].rc = done ? RC_OK : (isWrite ? RC_WRITE_FAILED : RC_READ_FAILED);
+		if (done && !isWrite)
+			aio->ready[aio->numReady].rc = verifyPageChecksum(mgmt, memPage);
+		aio->numReady++;
+		return RC_OK;
+	}
+
+	pthread_rwlock_unlock(&mgmt->latch);
+	int slot = 0;
+	while (aio->requests[slot].inUse)
+		slot++;
+	aio->requests[slot].inUse = true;
+	aio->requests[slot].tag = tag;
+	aio->requests[slot].page = memPage;
+	aio->requests[slot].isWrite = isWrite;
+	if (isWrite)
+	{
+		stampPageChecksum(memPage, mgmt->pageSize);
+		__atomic_store_n(&mgmt->unsynced, true, __ATOMIC_RELEASE);
+	}
+
+	unsigned tail = *aio->sqTail;
+	unsigned index = tail & *aio->sqMask;
+	struct io_uring_sqe *sqe = &aio->sqes[index];
+	memset(sqe, 0, sizeof(struct io_uring_sqe));
+	sqe->opcode = isWrite ? IORING_OP_WRITE : IORING_OP_READ;
+	sqe->fd = mgmt->fd;
+	sqe->off = offset;
+	sqe->addr = (unsigned long)memPage;
+	sqe->len = mgmt->pageSize;
+	sqe->user_data = slot;
+	aio->sqArray[index] = index;
+	__atomic_store_n(aio->sqTail, tail + 1, __ATOMIC_RELEASE);
+	aio->numQueued++;
+	aio->numInFlight++;
+	return RC_OK;
+}
+
+// queues an asynchronous read of page pageNum into memPage
+RC submitReadBlock(int64_t pageNum, SM_FileHandle *fHandle, SM_PageHandle memPage, void *tag)
+{
+	return submitBlock(pageNum, fHandle, memPage, tag, false);
+}
+
+// queues an asynchronous write of memPage to page pageNum
+RC submitWriteBlock(int64_t pageNum, SM_FileHandle *fHandle, SM_PageHandle memPage, void *tag)
+{
+	return submitBlock(pageNum, fHandle, memPage, tag, true);
+}
+
+// moves finished CQEs of the ring into completions (verifying the pages read), returns how many were taken
+int reapCompletions(SM_FileMgmt *mgmt, SM_AsyncIO *aio, SM_IOCompletion *completions, int maxCompletions)
+{
+	int taken = 0;
+	unsigned head = *aio->cqHead;
+	while (taken < maxCompletions && head != __atomic_load_n(aio->cqTail, __ATOMIC_ACQUIRE))
+	{
+		struct io_uring_cqe *cqe = &aio->cqes[head & *aio->cqMask];
+		SM_AsyncRequest *request = &aio->requests[cqe->user_data];
+		completions[taken].tag = request->tag;
+		if (cqe->res == mgmt->pageSize)
+			completions[taken].rc = request->isWrite ? RC_OK : verifyPageChecksum(mgmt, request->page);
+		else
+			completions[taken].rc = request->isWrite ? RC_WRITE_FAILED : RC_READ_FAILED;
+		request->inUse = false;
+		aio->numInFlight--;
+		taken++;
+		head++;
+	}
+	__atomic_store_n(aio->cqHead, head, __ATOMIC_RELEASE);
+	return taken;
+}
+
+/*
+1. This method hands queued requests to the kernel and collects finished ones into completions
+2. Blocks until at least minComplete requests have finished (0 = never block, only submit and collect)
+3. numCompleted is set to the number of entries filled in completions
+*/
+RC completeBlocks(SM_FileHandle *fHandle, int minComplete, SM_IOCompletion *completions, int maxCompletions, int *numCompleted)
+{
+	SM_AsyncIO *aio = getAsyncIO(fHandle);
+	*numCompleted = 0;
+	if (aio == NULL)
+		return checkValidfHandle(fHandle) ? RC_FILE_NOT_FOUND : RC_FILE_HANDLE_NOT_INIT;
+	if (minComplete > maxCompletions)
+		minComplete = maxCompletions;
+
+	// synchronous completions are ready right away
+	while (aio->numReady > 0 && *numCompleted < maxCompletions)
+	{
+		aio->numReady--;
+		completions[(*numCompleted)++] = aio->ready[aio->numReady];
+	}
+	if (aio->ringFd == -1)
+		return RC_OK;
+
+	*numCompleted += reapCompletions(fHandle->mgmtInfo, aio, completions + *numCompleted, maxCompletions - *numCompleted);
+	while (aio->numQueued > 0 || (*numCompleted < minComplete && aio->numInFlight > 0))
+	{
+		int wait = minComplete - *numCompleted;
+		if (wait < 0)
+			wait = 0;
+		if (wait > aio->numInFlight)
+			wait = aio->numInFlight;
+		int submitted = syscall(__NR_io_uring_enter, aio->ringFd, aio->numQueued, wait,
+								(wait > 0) ? IORING_ENTER_GETEVENTS : 0, NULL, 0);
+		if (submitted < 0)
+		{
+			if (errno == EINTR || errno == EAGAIN || errno == EBUSY)
+				continue;
+			return RC_ERROR;
+		}
+		aio->numQueued -= submitted;
+		*numCompleted += reapCompletions(fHandle->mgmtInfo, aio, completions + *numCompleted, maxCompletions - *numCompleted);
+	}
+	return RC_OK;
+}
@@ -1,43 +1,123 @@
 #ifndef STORAGE_MGR_H
 #define STORAGE_MGR_H
 
+#include <stddef.h>
+#include <stdint.h>
 #include "dberror.h"
 
 /************************************************************
  *                    handle data structures                *
  ************************************************************/
+#define SM_FILE_MAGIC 0x46504D53 /* "SMPF" */
+#define SM_FILE_VERSION 3
+#define SM_NO_FREE_PAGE -1
+
+// page sizes a page file can be created with (powers of two); PAGE_SIZE is the default
+#define SM_MIN_PAGE_SIZE 4096
+#define SM_MAX_PAGE_SIZE 65536
+
+// Binary header stored at the start of the header page of every page file.
+// It is read once by openPageFile and written back lazily (closePageFile or forceFileHeader).
+// Page numbers and counts are 64 bit so files are not limited to 2^31 pages.
+typedef struct SM_FileHeader {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t pageSize;
+	uint32_t reserved;
+	int64_t totalNumPages;
+	int64_t freeListHead;
+	int64_t tupleCount;
+	int64_t schemaPage;
+	uint32_t checksum;
+} SM_FileHeader;
+
 typedef struct SM_FileHandle {
 	char *fileName;
-	int totalNumPages;
-	int curPagePos;
+	int64_t totalNumPages;
+	int64_t curPagePos;
+	int pageSize; // bytes per page of this file, from its header; page buffers passed in must be this large
 	void *mgmtInfo;
 } SM_FileHandle;
 
 typedef char* SM_PageHandle;
 
+// The last SM_PAGE_TRAILER_SIZE bytes of every data page hold a CRC32C of the rest of the page.
+// They are overwritten by every write and checked by every read; callers may use SM_PAGE_DATA_BYTES(pageSize) bytes.
+#define SM_PAGE_TRAILER_SIZE 4
+#define SM_PAGE_DATA_BYTES(pageSize) ((pageSize) - SM_PAGE_TRAILER_SIZE)
+#define SM_PAGE_DATA_SIZE SM_PAGE_DATA_BYTES(PAGE_SIZE)
+
+// I/O backend used by an opened page file
+typedef enum SM_IOMode {
+	SM_IO_BUFFERED = 0, // positional pread/pwrite
+	SM_IO_MMAP = 1,     // shared memory mapping, pages copied with memcpy
+	SM_IO_DIRECT = 2    // O_DIRECT pread/pwrite, bypassing the kernel page cache
+} SM_IOMode;
+
+// buffer alignment required by SM_IO_DIRECT; page buffers aligned to this avoid a bounce copy
+#define SM_IO_ALIGNMENT 4096
+
+// default file growth: extents of 256 pages (1 MiB) or 10% of the allocated size, whichever is larger
+#define SM_DEFAULT_EXTENT_PAGES 256
+#define SM_DEFAULT_GROWTH_PERCENT 10
+
+// Result of an asynchronous page request, returned by completeBlocks
+typedef struct SM_IOCompletion {
+	void *tag; // tag given at submit time
+	RC rc;     // RC_OK, RC_READ_FAILED, RC_WRITE_FAILED or RC_PAGE_CHECKSUM_MISMATCH
+} SM_IOCompletion;
+
 /************************************************************
  *                    interface                             *
  ************************************************************/
 /* manipulating page files */
 extern void initStorageManager (void);
 extern RC createPageFile (char *fileName);
+extern RC createPageFileWithSize (char *fileName, int pageSize);
 extern RC openPageFile (char *fileName, SM_FileHandle *fHandle);
+extern RC openPageFileWithMode (char *fileName, SM_FileHandle *fHandle, SM_IOMode ioMode);
 extern RC closePageFile (SM_FileHandle *fHandle);
 extern RC destroyPageFile (char *fileName);
 
+/* page file header */
+extern RC getFileHeader (SM_FileHandle *fHandle, SM_FileHeader *header);
+extern RC setFileHeader (SM_FileHandle *fHandle, SM_FileHeader *header);
+extern RC forceFileHeader (SM_FileHandle *fHandle);
+
+/* durability: one fdatasync (msync for SM_IO_MMAP) of what was written since the last sync */
+extern RC syncPageFile (SM_FileHandle *fHandle);
+
+/* page checksums */
+extern uint32_t computeCRC32C (uint32_t crc, const void *data, size_t length);
+extern int getNumPageChecksumErrors (SM_FileHandle *fHandle);
+
 /* reading blocks from disc */
-extern RC readBlock (int pageNum, SM_FileHandle *fHandle, SM_PageHandle memPage);
-extern int getBlockPos (SM_FileHandle *fHandle);
+extern RC readBlock (int64_t pageNum, SM_FileHandle *fHandle, SM_PageHandle memPage);
+extern int64_t getBlockPos (SM_FileHandle *fHandle);
 extern RC readFirstBlock (SM_FileHandle *fHandle, SM_PageHandle memPage);
 extern RC readPreviousBlock (SM_FileHandle *fHandle, SM_PageHandle memPage);
 extern RC readCurrentBlock (SM_FileHandle *fHandle, SM_PageHandle memPage);
 extern RC readNextBlock (SM_FileHandle *fHandle, SM_PageHandle memPage);
 extern RC readLastBlock (SM_FileHandle *fHandle, SM_PageHandle memPage);
+extern RC readBlocks (int64_t startPage, int count, SM_FileHandle *fHandle, SM_PageHandle pages[]);
 
 /* writing blocks to a page file */
-extern RC writeBlock (int pageNum, SM_FileHandle *fHandle, SM_PageHandle memPage);
+extern RC writeBlock (int64_t pageNum, SM_FileHandle *fHandle, SM_PageHandle memPage);
 extern RC writeCurrentBlock (SM_FileHandle *fHandle, SM_PageHandle memPage);
+extern RC writeBlocks (int64_t startPage, int count, SM_FileHandle *fHandle, SM_PageHandle pages[]);
 extern RC appendEmptyBlock (SM_FileHandle *fHandle);
-extern RC ensureCapacity (int numberOfPages, SM_FileHandle *fHandle);
+extern RC ensureCapacity (int64_t numberOfPages, SM_FileHandle *fHandle);
+
+/* file growth (logical pages in totalNumPages, physical space reserved in extents) */
+extern RC setFileGrowth (SM_FileHandle *fHandle, int extentPages, int growthPercent);
+extern int64_t getAllocatedPages (SM_FileHandle *fHandle);
+
+/* asynchronous page I/O (io_uring, synchronous fallback when no ring can be created), used by one thread at a time */
+extern RC initAsyncIO (SM_FileHandle *fHandle, int queueDepth);
+extern RC shutdownAsyncIO (SM_FileHandle *fHandle);
+extern RC submitReadBlock (int64_t pageNum, SM_FileHandle *fHandle, SM_PageHandle memPage, void *tag);
+extern RC submitWriteBlock (int64_t pageNum, SM_FileHandle *fHandle, SM_PageHandle memPage, void *tag);
+extern RC completeBlocks (SM_FileHandle *fHandle, int minComplete, SM_IOCompletion *completions,
+		int maxCompletions, int *numCompleted);
 
 #endif
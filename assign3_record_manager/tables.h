@@ -1,6 +1,7 @@
 #ifndef TABLES_H
 #define TABLES_H
 
+#include <stdint.h>
 #include "dt.h"
 
 // Data Types, Records, and Schemas
@@ -22,7 +23,7 @@ typedef struct Value {
 } Value;
 
 typedef struct RID {
-	int page;
+	int64_t page; // same width as PageNumber
 	int slot;
 } RID;
 
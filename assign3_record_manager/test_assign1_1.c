@@ -0,0 +1,222 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "storage_mgr.h"
+#include "dberror.h"
+#include "test_helper.h"
+
+// test name
+char *testName;
+
+/* test output files */
+#define TESTPF "test_pagefile.bin"
+#define TESTPF_LARGE "test_pagefile_large.bin"
+
+// a page number whose byte offset is past 4 GiB with the default page size
+#define LARGE_PAGE_NUM (((int64_t)1 << 20) + 4096)
+
+/* prototypes for test functions */
+static void testCreateOpenClose(void);
+static void testSinglePageContent(void);
+static void testLargeSparseFile(void);
+static void testSyncPageFile(void);
+
+/* main function running all tests */
+int
+main (void)
+{
+	testName = "";
+
+	initStorageManager();
+
+	testCreateOpenClose();
+	testSinglePageContent();
+	testLargeSparseFile();
+	testSyncPageFile();
+
+	return 0;
+}
+
+
+/* check a return code. If it is not RC_OK then output a message, error description, and exit */
+/* Try to create, open, and close a page file */
+void
+testCreateOpenClose(void)
+{
+	SM_FileHandle fh;
+
+	testName = "test create open and close methods";
+
+	TEST_CHECK(createPageFile (TESTPF));
+
+	TEST_CHECK(openPageFile (TESTPF, &fh));
+	ASSERT_TRUE(strcmp(fh.fileName, TESTPF) == 0, "filename correct");
+	ASSERT_TRUE((fh.totalNumPages == 1), "expect 1 page in new file");
+	ASSERT_TRUE((fh.curPagePos == 0), "freshly opened file's page position should be 0");
+
+	TEST_CHECK(closePageFile (&fh));
+	TEST_CHECK(destroyPageFile (TESTPF));
+
+	// after destruction trying to open the file should cause an error
+	ASSERT_TRUE((openPageFile(TESTPF, &fh) != RC_OK), "opening non-existing file should return an error.");
+
+	TEST_DONE();
+}
+
+/* Try to create, open, and close a page file */
+void
+testSinglePageContent(void)
+{
+	SM_FileHandle fh;
+	SM_PageHandle ph;
+	int i;
+
+	testName = "test single page content";
+
+	ph = (SM_PageHandle) malloc(PAGE_SIZE);
+
+	// create a new page file
+	TEST_CHECK(createPageFile (TESTPF));
+	TEST_CHECK(openPageFile (TESTPF, &fh));
+	printf("created and opened file\n");
+
+	// read first page into handle
+	TEST_CHECK(readFirstBlock (&fh, ph));
+	// the page should be empty (zero bytes)
+	for (i=0; i < PAGE_SIZE; i++)
+		ASSERT_TRUE((ph[i] == 0), "expected zero byte in first page of freshly initialized page");
+	printf("first block was empty\n");
+
+	// change ph to be a string and write that one to disk
+	for (i=0; i < SM_PAGE_DATA_SIZE; i++)
+		ph[i] = (i % 10) + '0';
+	TEST_CHECK(writeBlock (0, &fh, ph));
+	printf("writing first block\n");
+
+	// read back the page containing the string and check that it is correct
+	TEST_CHECK(readFirstBlock (&fh, ph));
+	for (i=0; i < SM_PAGE_DATA_SIZE; i++)
+		ASSERT_TRUE((ph[i] == (i % 10) + '0'), "character in page read from disk is the one we expected.");
+	printf("reading first block\n");
+
+	// reading past the last page is an error
+	ASSERT_TRUE((readBlock(1, &fh, ph) == RC_READ_NON_EXISTING_PAGE), "reading a page past the end of the file fails");
+
+	// destroy new page file
+	TEST_CHECK(closePageFile (&fh));
+	TEST_CHECK(destroyPageFile (TESTPF));
+	free(ph);
+
+	TEST_DONE();
+}
+
+/* Grow a page file past 4 GiB and write a page there; the gap stays sparse */
+void
+testLargeSparseFile(void)
+{
+	SM_FileHandle fh;
+	SM_PageHandle ph;
+	struct stat fileStat;
+	int i;
+
+	testName = "test page file larger than 4 GiB";
+
+	ph = (SM_PageHandle) malloc(PAGE_SIZE);
+
+	TEST_CHECK(createPageFile (TESTPF_LARGE));
+	TEST_CHECK(openPageFile (TESTPF_LARGE, &fh));
+
+	// one step growth, only the tail extent is allocated
+	TEST_CHECK(ensureCapacity (LARGE_PAGE_NUM + 1, &fh));
+	ASSERT_TRUE((fh.totalNumPages == LARGE_PAGE_NUM + 1), "file holds the requested number of pages");
+
+	for (i=0; i < SM_PAGE_DATA_SIZE; i++)
+		ph[i] = (i % 26) + 'a';
+	TEST_CHECK(writeBlock (LARGE_PAGE_NUM, &fh, ph));
+	TEST_CHECK(closePageFile (&fh));
+
+	ASSERT_TRUE((stat(TESTPF_LARGE, &fileStat) == 0), "stat page file");
+	ASSERT_TRUE((fileStat.st_size > ((off_t)4 << 30)), "file is larger than 4 GiB");
+	ASSERT_TRUE(((off_t)fileStat.st_blocks * 512 < ((off_t)64 << 20)), "the gap before the last page is not allocated");
+
+	// the page count and the page past 4 GiB survive reopening
+	TEST_CHECK(openPageFile (TESTPF_LARGE, &fh));
+	ASSERT_TRUE((fh.totalNumPages == LARGE_PAGE_NUM + 1), "page count read back from the header");
+	memset(ph, 0, PAGE_SIZE);
+	TEST_CHECK(readLastBlock (&fh, ph));
+	ASSERT_TRUE((getBlockPos(&fh) == LARGE_PAGE_NUM), "current position is the last page");
+	for (i=0; i < SM_PAGE_DATA_SIZE; i++)
+		ASSERT_TRUE((ph[i] == (i % 26) + 'a'), "character in page past 4 GiB is the one we expected.");
+
+	// a page in the sparse gap reads back empty
+	TEST_CHECK(readBlock (LARGE_PAGE_NUM / 2, &fh, ph));
+	for (i=0; i < PAGE_SIZE; i++)
+		ASSERT_TRUE((ph[i] == 0), "expected zero byte in a page inside the sparse gap");
+
+	// growth past the jump is based on the reserved space, not on the sparse length
+	TEST_CHECK(appendEmptyBlock (&fh));
+	ASSERT_TRUE((stat(TESTPF_LARGE, &fileStat) == 0), "stat page file");
+	ASSERT_TRUE(((off_t)fileStat.st_blocks * 512 < ((off_t)64 << 20)), "the next extent is small");
+
+	TEST_CHECK(closePageFile (&fh));
+	TEST_CHECK(destroyPageFile (TESTPF_LARGE));
+	free(ph);
+
+	TEST_DONE();
+}
+
+/* Sync a page file after writing to it with every I/O backend; the pages are there after reopening it */
+void
+testSyncPageFile(void)
+{
+	SM_IOMode modes[] = { SM_IO_BUFFERED, SM_IO_MMAP, SM_IO_DIRECT };
+	SM_FileHandle fh;
+	SM_PageHandle pages[3];
+	RC openReturnCode;
+	int m, i;
+
+	testName = "test syncing a page file";
+
+	for (i = 0; i < 3; i++)
+		pages[i] = (SM_PageHandle) aligned_alloc(SM_IO_ALIGNMENT, PAGE_SIZE);
+	for (m = 0; m < 3; m++)
+	{
+		TEST_CHECK(createPageFile (TESTPF));
+		openReturnCode = openPageFileWithMode(TESTPF, &fh, modes[m]);
+		// some file systems (tmpfs) refuse O_DIRECT
+		if (openReturnCode == RC_DIRECT_IO_NOT_SUPPORTED)
+		{
+			TEST_CHECK(destroyPageFile (TESTPF));
+			continue;
+		}
+		TEST_CHECK(openReturnCode);
+		TEST_CHECK(syncPageFile (&fh));
+		TEST_CHECK(ensureCapacity (3, &fh));
+		for (i = 0; i < 3; i++)
+		{
+			memset(pages[i], 0, PAGE_SIZE);
+			sprintf(pages[i], "synced-%i", i);
+		}
+		TEST_CHECK(writeBlocks (0, 3, &fh, pages));
+		TEST_CHECK(syncPageFile (&fh));
+		// nothing written since, nothing to sync
+		TEST_CHECK(syncPageFile (&fh));
+		TEST_CHECK(closePageFile (&fh));
+		ASSERT_TRUE((syncPageFile(&fh) != RC_OK), "syncing a closed page file fails");
+
+		TEST_CHECK(openPageFile (TESTPF, &fh));
+		for (i = 0; i < 3; i++)
+		{
+			TEST_CHECK(readBlock (i, &fh, pages[0]));
+			ASSERT_TRUE((pages[0][7] == '0' + i && strncmp(pages[0], "synced-", 7) == 0), "page written before the sync");
+		}
+		TEST_CHECK(closePageFile (&fh));
+		TEST_CHECK(destroyPageFile (TESTPF));
+	}
+	for (i = 0; i < 3; i++)
+		free(pages[i]);
+
+	TEST_DONE();
+}
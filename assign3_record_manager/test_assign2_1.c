@@ -0,0 +1,1110 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "storage_mgr.h"
+#include "buffer_mgr.h"
+#include "buffer_mgr_stat.h"
+#include "dberror.h"
+#include "test_helper.h"
+
+// test name
+char *testName;
+
+/* test output files */
+#define TESTPF "testbuffer.bin"
+#define TESTPF2 "testbuffer2.bin"
+
+/* threads sharing a pool in testConcurrentPins, and the increments each of them does */
+#define NUM_PIN_THREADS 4
+#define NUM_THREAD_PINS 2000
+#define COUNTER_OFFSET 100
+
+// work of one thread of testConcurrentPins
+typedef struct PinThread {
+	BM_BufferPool *bm;
+	int numPages;
+	unsigned int seed;
+	RC result;
+} PinThread;
+
+/* prototypes for test functions */
+static void createDummyPages(BM_BufferPool *bm, int num);
+static void checkDummyPage(BM_PageHandle *h, int pageNum);
+static void pinAndCheck(BM_BufferPool *bm, BM_PageHandle *h, int pageNum);
+
+static void testCLOCK(void);
+static void testCLOCKPinnedAndDirty(void);
+static void testLFU(void);
+static void testLFUAging(void);
+static int streamAfterHotPage(BM_LFUData *lfuData, int numPages);
+static void testLRUK(void);
+static void testLRUKCorrelatedPeriod(void);
+static void testLRUKRetainedHistory(void);
+static int pinSequence(BM_LRUKData *lrukData, int numPages, const int *pages, int numPins);
+static void testARC(void);
+static void testConcurrentPins(void);
+static void *incrementPages(void *arg);
+static void testBackgroundFlush(void);
+static int waitForWrites(BM_BufferPool *bm, int numWrites);
+static void testHugePageArena(void);
+static void testPrefetch(void);
+static int waitForReads(BM_BufferPool *bm, int numReads);
+static void testScanRing(void);
+static void testSharedPool(void);
+static void testResize(void);
+static void testPoolStats(void);
+static void testWarmUp(void);
+
+/* main function running all tests */
+int
+main (void)
+{
+	initStorageManager();
+	testName = "";
+
+	testCLOCK();
+	testCLOCKPinnedAndDirty();
+	testLFU();
+	testLFUAging();
+	testLRUK();
+	testLRUKCorrelatedPeriod();
+	testLRUKRetainedHistory();
+	testARC();
+	testConcurrentPins();
+	testBackgroundFlush();
+	testHugePageArena();
+	testPrefetch();
+	testScanRing();
+	testSharedPool();
+	testResize();
+	testPoolStats();
+	testWarmUp();
+
+	return 0;
+}
+
+/* create num pages holding "Page-<pageNum>" */
+void
+createDummyPages(BM_BufferPool *bm, int num)
+{
+	int i;
+	BM_PageHandle *h = MAKE_PAGE_HANDLE();
+
+	CHECK(initBufferPool(bm, TESTPF, 3, RS_FIFO, NULL));
+
+	for (i = 0; i < num; i++)
+	{
+		CHECK(pinPage(bm, h, i));
+		sprintf(h->data, "%s-%i", "Page", i);
+		CHECK(markDirty(bm, h));
+		CHECK(unpinPage(bm, h));
+	}
+
+	CHECK(shutdownBufferPool(bm));
+
+	free(h);
+}
+
+/* check that a pinned page holds "Page-<pageNum>" */
+void
+checkDummyPage(BM_PageHandle *h, int pageNum)
+{
+	char *expected = malloc(sizeof(char) * 512);
+
+	sprintf(expected, "%s-%i", "Page", pageNum);
+	ASSERT_EQUALS_STRING(expected, h->data, "reading back dummy page content");
+
+	free(expected);
+}
+
+/* pin a page, check its content and unpin it again */
+void
+pinAndCheck(BM_BufferPool *bm, BM_PageHandle *h, int pageNum)
+{
+	TEST_CHECK(pinPage(bm, h, pageNum));
+	checkDummyPage(h, pageNum);
+	TEST_CHECK(unpinPage(bm, h));
+}
+
+/* CLOCK gives a referenced page a second chance and replaces the next unreferenced one */
+void
+testCLOCK(void)
+{
+	BM_BufferPool *bm = MAKE_POOL();
+	BM_PageHandle *h = MAKE_PAGE_HANDLE();
+	testName = "Testing CLOCK page replacement";
+
+	CHECK(createPageFile(TESTPF));
+	createDummyPages(bm, 10);
+
+	CHECK(initBufferPool(bm, TESTPF, 3, RS_CLOCK, NULL));
+
+	// fill the pool
+	pinAndCheck(bm, h, 0);
+	pinAndCheck(bm, h, 1);
+	pinAndCheck(bm, h, 2);
+	ASSERT_EQUALS_INT(3, getNumReadIO(bm), "check number of read I/Os after filling the pool");
+
+	// every frame is referenced, one sweep clears the bits and page 0 under the hand is replaced
+	pinAndCheck(bm, h, 3);
+	ASSERT_EQUALS_INT(4, getNumReadIO(bm), "page 3 is read");
+
+	// a hit only sets the reference bit of page 1
+	pinAndCheck(bm, h, 1);
+	ASSERT_EQUALS_INT(4, getNumReadIO(bm), "page 1 is a hit");
+
+	// the hand passes over page 1 and replaces page 2
+	pinAndCheck(bm, h, 4);
+	ASSERT_EQUALS_INT(5, getNumReadIO(bm), "page 4 is read");
+	pinAndCheck(bm, h, 1);
+	pinAndCheck(bm, h, 3);
+	ASSERT_EQUALS_INT(5, getNumReadIO(bm), "pages 1 and 3 stayed in the pool");
+	pinAndCheck(bm, h, 2);
+	ASSERT_EQUALS_INT(6, getNumReadIO(bm), "page 2 was replaced and is read again");
+
+	ASSERT_EQUALS_INT(0, getNumWriteIO(bm), "no page was modified");
+
+	CHECK(shutdownBufferPool(bm));
+	CHECK(destroyPageFile(TESTPF));
+
+	free(bm);
+	free(h);
+	TEST_DONE();
+}
+
+/* CLOCK never replaces pinned pages and writes dirty victims back */
+void
+testCLOCKPinnedAndDirty(void)
+{
+	BM_BufferPool *bm = MAKE_POOL();
+	BM_PageHandle *h = MAKE_PAGE_HANDLE();
+	BM_PageHandle *pinned = MAKE_PAGE_HANDLE();
+	BM_PageHandle *extra = MAKE_PAGE_HANDLE();
+	int i;
+	testName = "Testing CLOCK with pinned and dirty pages";
+
+	CHECK(createPageFile(TESTPF));
+	createDummyPages(bm, 10);
+
+	CHECK(initBufferPool(bm, TESTPF, 3, RS_CLOCK, NULL));
+
+	// page 0 stays pinned while the other frames cycle
+	TEST_CHECK(pinPage(bm, pinned, 0));
+
+	TEST_CHECK(pinPage(bm, h, 1));
+	sprintf(h->data, "%s-%i", "Page", 11);
+	TEST_CHECK(markDirty(bm, h));
+	TEST_CHECK(unpinPage(bm, h));
+
+	for (i = 2; i < 8; i++)
+		pinAndCheck(bm, h, i);
+	ASSERT_EQUALS_INT(1, getNumWriteIO(bm), "dirty page 1 was written back when it was replaced");
+	checkDummyPage(pinned, 0);
+
+	// the modified page comes back from disk
+	TEST_CHECK(pinPage(bm, h, 1));
+	checkDummyPage(h, 11);
+
+	// page 0 and page 1 are pinned, pinning a third page fills the last frame
+	TEST_CHECK(pinPage(bm, extra, 2));
+	ASSERT_EQUALS_INT(RC_NO_FREE_BUFFER_FRAME, pinPage(bm, h, 3), "every frame is pinned");
+
+	TEST_CHECK(unpinPage(bm, extra));
+	TEST_CHECK(unpinPage(bm, h));
+	TEST_CHECK(unpinPage(bm, pinned));
+
+	CHECK(shutdownBufferPool(bm));
+	CHECK(destroyPageFile(TESTPF));
+
+	free(bm);
+	free(h);
+	free(pinned);
+	free(extra);
+	TEST_DONE();
+}
+
+/* LFU replaces the page with the fewest uses, the least recently used one among equals */
+void
+testLFU(void)
+{
+	BM_BufferPool *bm = MAKE_POOL();
+	BM_PageHandle *h = MAKE_PAGE_HANDLE();
+	int i;
+	testName = "Testing LFU page replacement";
+
+	CHECK(createPageFile(TESTPF));
+	createDummyPages(bm, 10);
+
+	CHECK(initBufferPool(bm, TESTPF, 4, RS_LFU, NULL));
+
+	// page 0 is used three times, page 1 twice, pages 2 and 3 once
+	for (i = 0; i < 3; i++)
+		pinAndCheck(bm, h, 0);
+	pinAndCheck(bm, h, 1);
+	pinAndCheck(bm, h, 1);
+	pinAndCheck(bm, h, 2);
+	pinAndCheck(bm, h, 3);
+	ASSERT_EQUALS_INT(4, getNumReadIO(bm), "check number of read I/Os after filling the pool");
+
+	// pages 2 and 3 have the fewest uses, the older page 2 goes
+	pinAndCheck(bm, h, 4);
+	pinAndCheck(bm, h, 3);
+	pinAndCheck(bm, h, 0);
+	pinAndCheck(bm, h, 1);
+	ASSERT_EQUALS_INT(5, getNumReadIO(bm), "pages 0, 1 and 3 stayed in the pool");
+
+	// page 4 is now the only page used once
+	pinAndCheck(bm, h, 2);
+	ASSERT_EQUALS_INT(6, getNumReadIO(bm), "page 2 is read again");
+	pinAndCheck(bm, h, 4);
+	ASSERT_EQUALS_INT(7, getNumReadIO(bm), "page 4 was replaced by page 2");
+	pinAndCheck(bm, h, 3);
+	ASSERT_EQUALS_INT(7, getNumReadIO(bm), "page 3 stayed in the pool");
+
+	CHECK(shutdownBufferPool(bm));
+	CHECK(destroyPageFile(TESTPF));
+
+	free(bm);
+	free(h);
+	TEST_DONE();
+}
+
+/* use page 0 often, then stream pages 1..numPages through the pool, using each one twice */
+int
+streamAfterHotPage(BM_LFUData *lfuData, int numPages)
+{
+	BM_BufferPool *bm = MAKE_POOL();
+	BM_PageHandle *h = MAKE_PAGE_HANDLE();
+	int readsBefore;
+	int i;
+
+	CHECK(initBufferPool(bm, TESTPF, 2, RS_LFU, lfuData));
+	for (i = 0; i < 5; i++)
+		pinAndCheck(bm, h, 0);
+	for (i = 1; i <= numPages; i++)
+	{
+		pinAndCheck(bm, h, i);
+		pinAndCheck(bm, h, i);
+	}
+
+	// returns whether page 0 had to be read again
+	readsBefore = getNumReadIO(bm);
+	pinAndCheck(bm, h, 0);
+	i = getNumReadIO(bm) - readsBefore;
+
+	CHECK(shutdownBufferPool(bm));
+	free(bm);
+	free(h);
+	return i;
+}
+
+/* without aging a page that was hot once stays forever, aging lets it decay */
+void
+testLFUAging(void)
+{
+	BM_BufferPool *bm = MAKE_POOL();
+	BM_LFUData lfuData;
+	testName = "Testing LFU page replacement with aging";
+
+	CHECK(createPageFile(TESTPF));
+	createDummyPages(bm, 10);
+
+	lfuData.agingInterval = 0;
+	ASSERT_EQUALS_INT(0, streamAfterHotPage(&lfuData, 8), "page 0 stays in the pool without aging");
+	lfuData.agingInterval = 4;
+	ASSERT_EQUALS_INT(1, streamAfterHotPage(&lfuData, 8), "page 0 was replaced after aging");
+
+	CHECK(destroyPageFile(TESTPF));
+
+	free(bm);
+	TEST_DONE();
+}
+
+/* pin and unpin pages in order on a fresh LRU-K pool, returns the number of pages read */
+int
+pinSequence(BM_LRUKData *lrukData, int numPages, const int *pages, int numPins)
+{
+	BM_BufferPool *bm = MAKE_POOL();
+	BM_PageHandle *h = MAKE_PAGE_HANDLE();
+	int reads;
+	int i;
+
+	CHECK(initBufferPool(bm, TESTPF, numPages, RS_LRU_K, lrukData));
+	for (i = 0; i < numPins; i++)
+		pinAndCheck(bm, h, pages[i]);
+	reads = getNumReadIO(bm);
+
+	CHECK(shutdownBufferPool(bm));
+	free(bm);
+	free(h);
+	return reads;
+}
+
+/* LRU-2 replaces pages referenced once before pages referenced twice, so a scan does not flush the pool */
+void
+testLRUK(void)
+{
+	BM_BufferPool *bm = MAKE_POOL();
+	// pages 0 and 1 are used twice, then pages 2 to 5 are scanned once and pages 0 and 1 used again
+	const int pages[] = {0, 0, 1, 1, 2, 3, 4, 5, 0, 1};
+	testName = "Testing LRU-K page replacement";
+
+	CHECK(createPageFile(TESTPF));
+	createDummyPages(bm, 10);
+
+	ASSERT_EQUALS_INT(6, pinSequence(NULL, 3, pages, 10), "pages 0 and 1 survive the scan");
+
+	CHECK(destroyPageFile(TESTPF));
+
+	free(bm);
+	TEST_DONE();
+}
+
+/* references within the correlated reference period count as one, and the page cannot be replaced during it */
+void
+testLRUKCorrelatedPeriod(void)
+{
+	BM_BufferPool *bm = MAKE_POOL();
+	BM_LRUKData lrukData;
+	// the second uses of pages 0 and 1 are correlated, page 3 can only replace page 0
+	const int pages[] = {0, 0, 1, 1, 2, 3, 1, 2, 0};
+	testName = "Testing LRU-K correlated reference period";
+
+	CHECK(createPageFile(TESTPF));
+	createDummyPages(bm, 10);
+
+	lrukData.k = 2;
+	lrukData.correlatedPeriod = 2;
+	lrukData.historySize = 0;
+	ASSERT_EQUALS_INT(4, pinSequence(&lrukData, 3, pages, 8), "pages 1 and 2 are still in their correlated period");
+	ASSERT_EQUALS_INT(5, pinSequence(&lrukData, 3, pages, 9), "page 0 was replaced");
+
+	CHECK(destroyPageFile(TESTPF));
+
+	free(bm);
+	TEST_DONE();
+}
+
+/* a page coming back keeps the reference times of its previous stay in the pool */
+void
+testLRUKRetainedHistory(void)
+{
+	BM_BufferPool *bm = MAKE_POOL();
+	BM_LRUKData lrukData;
+	// page 0 is replaced by page 2 and comes back, then page 3 replaces page 1 or page 0
+	const int pages[] = {0, 1, 1, 0, 2, 0, 3, 0};
+	testName = "Testing LRU-K retained history";
+
+	CHECK(createPageFile(TESTPF));
+	createDummyPages(bm, 10);
+
+	lrukData.k = 2;
+	lrukData.correlatedPeriod = 0;
+	lrukData.historySize = 4;
+	ASSERT_EQUALS_INT(5, pinSequence(&lrukData, 2, pages, 8), "page 0 was used twice before, page 1 is replaced");
+	lrukData.historySize = 0;
+	ASSERT_EQUALS_INT(6, pinSequence(&lrukData, 2, pages, 8), "without retained history page 0 counts as used once");
+
+	CHECK(destroyPageFile(TESTPF));
+
+	free(bm);
+	TEST_DONE();
+}
+
+/* ARC keeps pages used twice (T2) through a scan and promotes a scanned page that comes back */
+void
+testARC(void)
+{
+	BM_BufferPool *bm = MAKE_POOL();
+	BM_PageHandle *h = MAKE_PAGE_HANDLE();
+	int i;
+	testName = "Testing ARC page replacement";
+
+	CHECK(createPageFile(TESTPF));
+	createDummyPages(bm, 20);
+
+	CHECK(initBufferPool(bm, TESTPF, 4, RS_ARC, NULL));
+
+	// pages 0 and 1 are used twice, then pages 2 to 9 are scanned once
+	pinAndCheck(bm, h, 0);
+	pinAndCheck(bm, h, 0);
+	pinAndCheck(bm, h, 1);
+	pinAndCheck(bm, h, 1);
+	for (i = 2; i < 10; i++)
+		pinAndCheck(bm, h, i);
+	ASSERT_EQUALS_INT(10, getNumReadIO(bm), "check number of read I/Os after the scan");
+	pinAndCheck(bm, h, 0);
+	pinAndCheck(bm, h, 1);
+	ASSERT_EQUALS_INT(10, getNumReadIO(bm), "pages 0 and 1 survive the scan");
+
+	// page 7 was just replaced, its ghost brings it back as a frequent page
+	pinAndCheck(bm, h, 7);
+	ASSERT_EQUALS_INT(11, getNumReadIO(bm), "page 7 is read again");
+	for (i = 10; i < 14; i++)
+		pinAndCheck(bm, h, i);
+	pinAndCheck(bm, h, 7);
+	ASSERT_EQUALS_INT(15, getNumReadIO(bm), "page 7 survives the next scan");
+
+	CHECK(shutdownBufferPool(bm));
+	CHECK(destroyPageFile(TESTPF));
+
+	free(bm);
+	free(h);
+	TEST_DONE();
+}
+
+/* each thread pins random pages and increments a counter on them under the exclusive page latch */
+void *
+incrementPages(void *arg)
+{
+	PinThread *thread = (PinThread *)arg;
+	BM_PageHandle h;
+	int i, counter;
+
+	thread->result = RC_OK;
+	for (i = 0; i < NUM_THREAD_PINS && thread->result == RC_OK; i++)
+	{
+		thread->result = pinPage(thread->bm, &h, rand_r(&thread->seed) % thread->numPages);
+		if (thread->result != RC_OK)
+			break;
+		thread->result = latchPage(thread->bm, &h, 1);
+		if (thread->result == RC_OK)
+		{
+			memcpy(&counter, h.data + COUNTER_OFFSET, sizeof(int));
+			counter++;
+			memcpy(h.data + COUNTER_OFFSET, &counter, sizeof(int));
+			thread->result = markDirty(thread->bm, &h);
+			unlatchPage(thread->bm, &h);
+		}
+		unpinPage(thread->bm, &h);
+	}
+	return NULL;
+}
+
+/* threads pinning pages of a pool smaller than the page set lose no update and leave every page intact */
+void
+testConcurrentPins(void)
+{
+	ReplacementStrategy strategies[] = { RS_FIFO, RS_LRU, RS_CLOCK, RS_LFU, RS_LRU_K, RS_ARC };
+	BM_BufferPool *bm = MAKE_POOL();
+	BM_PageHandle *h = MAKE_PAGE_HANDLE();
+	PinThread threads[NUM_PIN_THREADS];
+	pthread_t ids[NUM_PIN_THREADS];
+	int numPages = 16;
+	int s, i, counter, total;
+	testName = "Testing pins from several threads";
+
+	for (s = 0; s < (int)(sizeof(strategies) / sizeof(strategies[0])); s++)
+	{
+		CHECK(createPageFile(TESTPF));
+		createDummyPages(bm, numPages);
+
+		// every thread holds at most one pin, the pool is a few frames larger than that
+		CHECK(initBufferPool(bm, TESTPF, NUM_PIN_THREADS + 2, strategies[s], NULL));
+		for (i = 0; i < NUM_PIN_THREADS; i++)
+		{
+			threads[i].bm = bm;
+			threads[i].numPages = numPages;
+			threads[i].seed = i + 1;
+			ASSERT_TRUE((pthread_create(&ids[i], NULL, incrementPages, &threads[i]) == 0), "start pinning thread");
+		}
+		for (i = 0; i < NUM_PIN_THREADS; i++)
+		{
+			pthread_join(ids[i], NULL);
+			TEST_CHECK(threads[i].result);
+		}
+		CHECK(shutdownBufferPool(bm));
+
+		// the counters on disk add up to every increment done
+		CHECK(initBufferPool(bm, TESTPF, 3, RS_FIFO, NULL));
+		total = 0;
+		for (i = 0; i < numPages; i++)
+		{
+			pinAndCheck(bm, h, i);
+			memcpy(&counter, h->data + COUNTER_OFFSET, sizeof(int));
+			total += counter;
+		}
+		ASSERT_EQUALS_INT(NUM_PIN_THREADS * NUM_THREAD_PINS, total, "no increment is lost");
+		CHECK(shutdownBufferPool(bm));
+		CHECK(destroyPageFile(TESTPF));
+	}
+
+	free(bm);
+	free(h);
+	TEST_DONE();
+}
+
+/* wait up to five seconds for the pool to have done numWrites writes, returns the writes done */
+int
+waitForWrites(BM_BufferPool *bm, int numWrites)
+{
+	int i;
+	for (i = 0; i < 500 && getNumWriteIO(bm) < numWrites; i++)
+		usleep(10000);
+	return getNumWriteIO(bm);
+}
+
+/* the background flusher writes dirty unpinned pages on its interval, or early once too many frames are dirty */
+void
+testBackgroundFlush(void)
+{
+	BM_BufferPool *bm = MAKE_POOL();
+	BM_PageHandle *h = MAKE_PAGE_HANDLE();
+	BM_PoolOptions options;
+	SM_FileHandle fh;
+	SM_PageHandle ph = (SM_PageHandle) malloc(PAGE_SIZE);
+	bool *dirtyFlags;
+	int i;
+	testName = "Testing the background flusher";
+
+	CHECK(createPageFile(TESTPF));
+	createDummyPages(bm, 10);
+
+	// rounds every 20 ms write every dirty unpinned page
+	initPoolOptions(&options);
+	options.backgroundFlush = 1;
+	options.flushInterval = 20;
+	options.dirtyHighRatio = 100;
+	options.dirtyLowRatio = 0;
+	CHECK(initBufferPoolWithOptions(bm, TESTPF, 10, RS_FIFO, NULL, &options));
+	for (i = 0; i < 5; i++)
+	{
+		CHECK(pinPage(bm, h, i));
+		sprintf(h->data, "%s-%i", "Flushed", i);
+		CHECK(markDirty(bm, h));
+		CHECK(unpinPage(bm, h));
+	}
+	ASSERT_EQUALS_INT(5, waitForWrites(bm, 5), "the flusher writes the dirty pages");
+	dirtyFlags = getDirtyFlags(bm);
+	for (i = 0; i < 10; i++)
+		ASSERT_TRUE(!dirtyFlags[i], "no frame is dirty after the flusher's round");
+	free(dirtyFlags);
+
+	// the page is on disk before the pool is shut down
+	CHECK(openPageFile(TESTPF, &fh));
+	CHECK(readBlock(2, &fh, ph));
+	ASSERT_EQUALS_STRING("Flushed-2", ph, "page written by the flusher");
+	CHECK(closePageFile(&fh));
+	CHECK(shutdownBufferPool(bm));
+
+	// a long interval, but the third dirty page of four frames crosses the 50% ratio and wakes the flusher
+	options.flushInterval = 60000;
+	options.dirtyHighRatio = 50;
+	CHECK(initBufferPoolWithOptions(bm, TESTPF, 4, RS_FIFO, NULL, &options));
+	for (i = 0; i < 3; i++)
+	{
+		CHECK(pinPage(bm, h, i));
+		CHECK(markDirty(bm, h));
+		CHECK(unpinPage(bm, h));
+	}
+	ASSERT_EQUALS_INT(3, waitForWrites(bm, 3), "the flusher is woken by the dirty ratio");
+	CHECK(shutdownBufferPool(bm));
+	CHECK(destroyPageFile(TESTPF));
+
+	free(ph);
+	free(bm);
+	free(h);
+	TEST_DONE();
+}
+
+/* a pool larger than a huge page keeps every page intact, the stats list the frames in arena order */
+void
+testHugePageArena(void)
+{
+	BM_BufferPool *bm = MAKE_POOL();
+	BM_PageHandle *h = MAKE_PAGE_HANDLE();
+	BM_PoolOptions options;
+	PageNumber *frameContents;
+	int numFrames = 600;
+	int i;
+	testName = "Testing the huge page frame arena";
+
+	CHECK(createPageFile(TESTPF));
+	createDummyPages(bm, numFrames + 50);
+
+	// falls back to transparent huge pages if none are reserved
+	initPoolOptions(&options);
+	options.hugePages = 1;
+	CHECK(initBufferPoolWithOptions(bm, TESTPF, numFrames, RS_FIFO, NULL, &options));
+	for (i = 0; i < 3; i++)
+		pinAndCheck(bm, h, i);
+	frameContents = getFrameContents(bm);
+	ASSERT_EQUALS_INT(0, (int)frameContents[0], "first frame holds page 0");
+	ASSERT_EQUALS_INT(2, (int)frameContents[2], "third frame holds page 2");
+	ASSERT_EQUALS_INT(NO_PAGE, (int)frameContents[3], "fourth frame is empty");
+	free(frameContents);
+
+	// fill the pool and replace the first pages
+	for (i = 3; i < numFrames + 50; i++)
+		pinAndCheck(bm, h, i);
+	for (i = 0; i < numFrames + 50; i += 7)
+		pinAndCheck(bm, h, i);
+	CHECK(shutdownBufferPool(bm));
+	CHECK(destroyPageFile(TESTPF));
+
+	free(bm);
+	free(h);
+	TEST_DONE();
+}
+
+/* wait up to five seconds for the pool to have done numReads reads, returns the reads done */
+int
+waitForReads(BM_BufferPool *bm, int numReads)
+{
+	int i;
+	for (i = 0; i < 500 && getNumReadIO(bm) < numReads; i++)
+		usleep(10000);
+	return getNumReadIO(bm);
+}
+
+/* prefetched pages are read in the background, pins of them read nothing more */
+void
+testPrefetch(void)
+{
+	BM_BufferPool *bm = MAKE_POOL();
+	BM_PageHandle *h = MAKE_PAGE_HANDLE();
+	BM_PoolOptions options;
+	int queueDepths[] = { 32, 0 };
+	int q, i;
+	testName = "Testing prefetching pages";
+
+	CHECK(createPageFile(TESTPF));
+	createDummyPages(bm, 20);
+
+	// with the async engine and with synchronous reads
+	for (q = 0; q < 2; q++)
+	{
+		initPoolOptions(&options);
+		options.ioQueueDepth = queueDepths[q];
+		CHECK(initBufferPoolWithOptions(bm, TESTPF, 10, RS_FIFO, NULL, &options));
+		CHECK(prefetchPages(bm, 2, 4));
+		ASSERT_EQUALS_INT(4, waitForReads(bm, 4), "prefetched pages are read without a pin");
+		for (i = 2; i < 6; i++)
+			pinAndCheck(bm, h, i);
+		ASSERT_EQUALS_INT(4, getNumReadIO(bm), "pins of prefetched pages read nothing");
+
+		// pages past the end of the file are skipped
+		CHECK(prefetchPages(bm, 18, 10));
+		ASSERT_EQUALS_INT(6, waitForReads(bm, 6), "only pages in the file are prefetched");
+
+		// one call prefetches at most half of the pool
+		CHECK(prefetchPages(bm, 6, 100));
+		ASSERT_EQUALS_INT(11, waitForReads(bm, 11), "five pages are prefetched");
+		usleep(50000);
+		ASSERT_EQUALS_INT(11, getNumReadIO(bm), "no more than five pages are prefetched");
+		for (i = 6; i < 11; i++)
+			pinAndCheck(bm, h, i);
+		pinAndCheck(bm, h, 19);
+		ASSERT_EQUALS_INT(11, getNumReadIO(bm), "pins of prefetched pages read nothing");
+		CHECK(shutdownBufferPool(bm));
+	}
+	CHECK(destroyPageFile(TESTPF));
+
+	free(bm);
+	free(h);
+	TEST_DONE();
+}
+
+/* a scan through a ring recycles the ring's frames and leaves the hot pages of the pool alone */
+void
+testScanRing(void)
+{
+	BM_BufferPool *bm = MAKE_POOL();
+	BM_PageHandle *h = MAKE_PAGE_HANDLE();
+	BM_ScanRing ring;
+	ReplacementStrategy strategies[] = { RS_FIFO, RS_LRU, RS_CLOCK, RS_LFU, RS_LRU_K, RS_ARC };
+	int s, i;
+	testName = "Testing scan rings";
+
+	CHECK(createPageFile(TESTPF));
+	createDummyPages(bm, 45);
+
+	for (s = 0; s < 6; s++)
+	{
+		CHECK(initBufferPool(bm, TESTPF, 10, strategies[s], NULL));
+		// hot pages, used twice each
+		for (i = 0; i < 10; i++)
+			pinAndCheck(bm, h, i % 5);
+		CHECK(initScanRing(bm, &ring, 8));
+		ASSERT_EQUALS_INT(5, ring.numFrames, "a ring takes at most half of the pool");
+		CHECK(shutdownScanRing(bm, &ring));
+		CHECK(initScanRing(bm, &ring, 3));
+
+		for (i = 5; i < 40; i++)
+		{
+			TEST_CHECK(pinPageWithRing(bm, &ring, h, i));
+			checkDummyPage(h, i);
+			TEST_CHECK(unpinPage(bm, h));
+			// a page pinned by someone else as well stays in the pool
+			if (i == 20)
+				pinAndCheck(bm, h, 20);
+		}
+		ASSERT_EQUALS_INT(40, getNumReadIO(bm), "every page of the scan is read once");
+		for (i = 0; i < 5; i++)
+			pinAndCheck(bm, h, i);
+		pinAndCheck(bm, h, 20);
+		ASSERT_EQUALS_INT(40, getNumReadIO(bm), "the hot pages are still in the pool after the scan");
+
+		// read-ahead into the ring keeps a frame for the page being read
+		CHECK(prefetchRingPages(bm, &ring, 40, 5));
+		ASSERT_EQUALS_INT(42, waitForReads(bm, 42), "two pages are prefetched into the ring");
+		for (i = 40; i < 42; i++)
+		{
+			TEST_CHECK(pinPageWithRing(bm, &ring, h, i));
+			checkDummyPage(h, i);
+			TEST_CHECK(unpinPage(bm, h));
+		}
+		for (i = 0; i < 5; i++)
+			pinAndCheck(bm, h, i);
+		ASSERT_EQUALS_INT(42, getNumReadIO(bm), "prefetches into the ring replace no hot page");
+		CHECK(shutdownScanRing(bm, &ring));
+		CHECK(shutdownBufferPool(bm));
+	}
+	CHECK(destroyPageFile(TESTPF));
+
+	free(bm);
+	free(h);
+	TEST_DONE();
+}
+
+/* page files attached to one pool share its frames, a page is told apart by its file id */
+void
+testSharedPool(void)
+{
+	BM_BufferPool *bm = MAKE_POOL();
+	BM_PageHandle *h = MAKE_PAGE_HANDLE();
+	BM_PoolOptions options;
+	ReplacementStrategy strategies[] = { RS_FIFO, RS_LRU, RS_CLOCK, RS_LFU, RS_LRU_K, RS_ARC };
+	char expected[64];
+	int s, i, file1, file2;
+	testName = "Testing a buffer pool shared by page files";
+
+	CHECK(createPageFile(TESTPF));
+	createDummyPages(bm, 10);
+	initPoolOptions(&options);
+
+	for (s = 0; s < 6; s++)
+	{
+		CHECK(createPageFile(TESTPF2));
+		CHECK(initBufferPoolWithOptions(bm, NULL, 6, strategies[s], NULL, &options));
+		ASSERT_TRUE(pinPage(bm, h, 0) != RC_OK, "a pool without a page file of its own has no file 0");
+		TEST_CHECK(attachPageFile(bm, TESTPF, &file1));
+		TEST_CHECK(attachPageFile(bm, TESTPF2, &file2));
+		ASSERT_TRUE(file1 != 0 && file2 != 0 && file1 != file2, "attached files get ids of their own");
+
+		// the same page numbers of both files are in the pool together
+		for (i = 0; i < 10; i++)
+		{
+			TEST_CHECK(pinFilePage(bm, file2, h, i));
+			ASSERT_EQUALS_INT(file2, h->fileId, "the handle carries the file of the page");
+			sprintf(h->data, "%s-%i", "Other", i);
+			TEST_CHECK(markDirty(bm, h));
+			TEST_CHECK(unpinPage(bm, h));
+			TEST_CHECK(pinFilePage(bm, file1, h, i));
+			checkDummyPage(h, i);
+			TEST_CHECK(unpinPage(bm, h));
+		}
+
+		TEST_CHECK(pinFilePage(bm, file2, h, 3));
+		ASSERT_TRUE(detachPageFile(bm, file2) != RC_OK, "a file with a pinned page stays attached");
+		TEST_CHECK(unpinPage(bm, h));
+		TEST_CHECK(detachPageFile(bm, file2));
+		ASSERT_TRUE(pinFilePage(bm, file2, h, 0) != RC_OK, "pages of a detached file cannot be pinned");
+
+		// the detach wrote the dirty pages of the file
+		TEST_CHECK(attachPageFile(bm, TESTPF2, &file2));
+		for (i = 0; i < 10; i++)
+		{
+			TEST_CHECK(pinFilePage(bm, file2, h, i));
+			sprintf(expected, "%s-%i", "Other", i);
+			ASSERT_EQUALS_STRING(expected, h->data, "reading back a page written by the detach");
+			TEST_CHECK(unpinPage(bm, h));
+		}
+		for (i = 0; i < 10; i++)
+		{
+			TEST_CHECK(pinFilePage(bm, file1, h, i));
+			checkDummyPage(h, i);
+			TEST_CHECK(unpinPage(bm, h));
+		}
+		CHECK(shutdownBufferPool(bm));
+		CHECK(destroyPageFile(TESTPF2));
+	}
+	CHECK(destroyPageFile(TESTPF));
+
+	free(bm);
+	free(h);
+	TEST_DONE();
+}
+
+/* a pool grows and shrinks while it is in use, pinned pages keep their frames */
+void
+testResize(void)
+{
+	BM_BufferPool *bm = MAKE_POOL();
+	BM_PageHandle *h = MAKE_PAGE_HANDLE();
+	BM_PageHandle handles[12];
+	ReplacementStrategy strategies[] = { RS_FIFO, RS_LRU, RS_CLOCK, RS_LFU, RS_LRU_K, RS_ARC };
+	PinThread threads[NUM_PIN_THREADS];
+	pthread_t ids[NUM_PIN_THREADS];
+	PageNumber *frameContents;
+	bool *dirtyFlags;
+	int *fixCounts;
+	int s, i, numWrites, numReads, numFrames, counter, total;
+	testName = "Testing resizing a buffer pool in use";
+
+	for (s = 0; s < 6; s++)
+	{
+		CHECK(createPageFile(TESTPF));
+		createDummyPages(bm, 30);
+		CHECK(initBufferPool(bm, TESTPF, 10, strategies[s], NULL));
+		for (i = 0; i < 10; i++)
+		{
+			TEST_CHECK(pinPage(bm, &handles[i], i));
+			checkDummyPage(&handles[i], i);
+		}
+		sprintf(handles[5].data, "%s-%i", "Resized", 5);
+		TEST_CHECK(markDirty(bm, &handles[5]));
+		for (i = 0; i < 10; i++)
+			if (i != 3 && i != 7)
+				TEST_CHECK(unpinPage(bm, &handles[i]));
+
+		// the shrink writes the dirty page back and keeps the pinned ones where they are
+		numWrites = getNumWriteIO(bm);
+		TEST_CHECK(resizeBufferPool(bm, 2));
+		ASSERT_EQUALS_INT(2, bm->numPages, "the pool has two frames left");
+		ASSERT_EQUALS_INT(numWrites + 1, getNumWriteIO(bm), "the dirty page was written back");
+		frameContents = getFrameContents(bm);
+		fixCounts = getFixCounts(bm);
+		ASSERT_TRUE(frameContents[0] + frameContents[1] == 10 && fixCounts[0] == 1 && fixCounts[1] == 1, "the pinned pages stay");
+		free(frameContents);
+		free(fixCounts);
+		numFrames = getPoolContents(bm, &frameContents, &dirtyFlags, &fixCounts);
+		ASSERT_EQUALS_INT(2, numFrames, "the snapshot has one entry per frame");
+		ASSERT_TRUE(frameContents[0] + frameContents[1] == 10 && !dirtyFlags[0] && !dirtyFlags[1], "the snapshot agrees with the getters");
+		free(frameContents);
+		free(dirtyFlags);
+		free(fixCounts);
+		checkDummyPage(&handles[3], 3);
+		checkDummyPage(&handles[7], 7);
+		ASSERT_TRUE(resizeBufferPool(bm, 1) == RC_NO_FREE_BUFFER_FRAME, "pinned pages cannot be evicted");
+		ASSERT_EQUALS_INT(2, bm->numPages, "the pool keeps the frames of pinned pages");
+		TEST_CHECK(unpinPage(bm, &handles[3]));
+		TEST_CHECK(unpinPage(bm, &handles[7]));
+
+		// twelve pages fit the grown pool
+		TEST_CHECK(resizeBufferPool(bm, 12));
+		ASSERT_EQUALS_INT(12, bm->numPages, "the pool has twelve frames");
+		for (i = 0; i < 12; i++)
+		{
+			TEST_CHECK(pinPage(bm, h, i));
+			TEST_CHECK(unpinPage(bm, h));
+		}
+		numReads = getNumReadIO(bm);
+		for (i = 0; i < 12; i++)
+		{
+			TEST_CHECK(pinPage(bm, h, i));
+			if (i == 5)
+				ASSERT_EQUALS_STRING("Resized-5", h->data, "reading back the page written by the shrink");
+			else
+				checkDummyPage(h, i);
+			TEST_CHECK(unpinPage(bm, h));
+		}
+		ASSERT_EQUALS_INT(numReads, getNumReadIO(bm), "no page is read again");
+
+		// pins from several threads go on while the pool grows and shrinks, every thread holds at most one pin
+		for (i = 0; i < NUM_PIN_THREADS; i++)
+		{
+			threads[i].bm = bm;
+			threads[i].numPages = 16;
+			threads[i].seed = i + 1;
+			ASSERT_TRUE((pthread_create(&ids[i], NULL, incrementPages, &threads[i]) == 0), "start pinning thread");
+		}
+		for (i = 0; i < 20; i++)
+		{
+			TEST_CHECK(resizeBufferPool(bm, (i % 2 == 0) ? NUM_PIN_THREADS + 2 : 16));
+			usleep(1000);
+		}
+		for (i = 0; i < NUM_PIN_THREADS; i++)
+		{
+			pthread_join(ids[i], NULL);
+			TEST_CHECK(threads[i].result);
+		}
+		CHECK(shutdownBufferPool(bm));
+
+		// the counters on disk add up to every increment done
+		CHECK(initBufferPool(bm, TESTPF, 3, RS_FIFO, NULL));
+		total = 0;
+		for (i = 0; i < 16; i++)
+		{
+			TEST_CHECK(pinPage(bm, h, i));
+			memcpy(&counter, h->data + COUNTER_OFFSET, sizeof(int));
+			total += counter;
+			TEST_CHECK(unpinPage(bm, h));
+		}
+		ASSERT_EQUALS_INT(NUM_PIN_THREADS * NUM_THREAD_PINS, total, "no increment is lost");
+		CHECK(shutdownBufferPool(bm));
+		CHECK(destroyPageFile(TESTPF));
+	}
+
+	free(bm);
+	free(h);
+	TEST_DONE();
+}
+
+/* the pool counts hits, misses, evictions and the writes they cause, and dumps them as text or JSON */
+void
+testPoolStats(void)
+{
+	BM_BufferPool *bm = MAKE_POOL();
+	BM_PageHandle *h = MAKE_PAGE_HANDLE();
+	BM_PoolStats stats;
+	char *message;
+	int i;
+	testName = "Testing buffer pool statistics";
+
+	CHECK(createPageFile(TESTPF));
+	createDummyPages(bm, 10);
+
+	// three misses fill the pool, two hits, then three misses replace every page, one of them dirty
+	CHECK(initBufferPool(bm, TESTPF, 3, RS_LRU, NULL));
+	for (i = 0; i < 3; i++)
+		pinAndCheck(bm, h, i);
+	pinAndCheck(bm, h, 0);
+	TEST_CHECK(pinPage(bm, h, 1));
+	TEST_CHECK(markDirty(bm, h));
+	TEST_CHECK(unpinPage(bm, h));
+	for (i = 3; i < 6; i++)
+		pinAndCheck(bm, h, i);
+	TEST_CHECK(pinPage(bm, h, 5));
+	TEST_CHECK(markDirty(bm, h));
+	TEST_CHECK(unpinPage(bm, h));
+	TEST_CHECK(forceFlushPool(bm));
+
+	TEST_CHECK(getPoolStats(bm, &stats));
+	ASSERT_EQUALS_INT(3, stats.numFrames, "frames of the pool");
+	ASSERT_EQUALS_INT(3, stats.residentPages, "every frame holds a page");
+	ASSERT_EQUALS_INT(0, stats.dirtyPages, "the flush left no dirty page");
+	ASSERT_EQUALS_INT(0, stats.pinnedFrames, "no page is pinned");
+	ASSERT_EQUALS_INT(3, (int)stats.hits, "hits");
+	ASSERT_EQUALS_INT(6, (int)stats.misses, "misses");
+	ASSERT_EQUALS_INT(2, (int)stats.cleanEvictions, "clean pages replaced");
+	ASSERT_EQUALS_INT(1, (int)stats.dirtyEvictions, "dirty pages replaced");
+	ASSERT_EQUALS_INT(6, (int)stats.reads, "pages read");
+	ASSERT_EQUALS_INT(1, (int)stats.evictionWrites, "pages written by evictions");
+	ASSERT_EQUALS_INT(1, (int)stats.flushWrites, "pages written by the flush");
+
+	message = sprintPoolStats(bm, BM_STATS_TEXT);
+	ASSERT_TRUE(strstr(message, "hits 3 misses 6 (hit ratio 33.3%)") != NULL, "text dump has the hit ratio");
+	free(message);
+	message = sprintPoolStats(bm, BM_STATS_JSON);
+	ASSERT_TRUE(strstr(message, "\"hits\":3,\"misses\":6,") != NULL && strstr(message, "\"strategyStats\":{}") != NULL, "JSON dump");
+	free(message);
+	CHECK(shutdownBufferPool(bm));
+
+	// every page of a full CLOCK pool is referenced, the hand clears each bit once before it replaces one
+	CHECK(initBufferPool(bm, TESTPF, 3, RS_CLOCK, NULL));
+	for (i = 0; i < 4; i++)
+		pinAndCheck(bm, h, i);
+	TEST_CHECK(getPoolStats(bm, &stats));
+	ASSERT_EQUALS_INT(3, (int)stats.clockSecondChances, "second chances given by the clock hand");
+	message = sprintPoolStats(bm, BM_STATS_JSON);
+	ASSERT_TRUE(strstr(message, "\"strategyStats\":{\"secondChances\":3}") != NULL, "JSON dump of the strategy");
+	free(message);
+	CHECK(shutdownBufferPool(bm));
+	CHECK(destroyPageFile(TESTPF));
+
+	free(bm);
+	free(h);
+	TEST_DONE();
+}
+
+/* pages resident at shutdown come back at the next init, at detach at the next attach */
+void
+testWarmUp(void)
+{
+	BM_BufferPool *bm = MAKE_POOL();
+	BM_PageHandle *h = MAKE_PAGE_HANDLE();
+	BM_PageHandle handles[6];
+	BM_PoolOptions options;
+	PageNumber *frameContents;
+	int i, numReads, fileId;
+	testName = "Testing warming up a buffer pool from the pages resident at shutdown";
+
+	destroyWarmUpList(TESTPF);
+	CHECK(createPageFile(TESTPF));
+	createDummyPages(bm, 20);
+	initPoolOptions(&options);
+	options.warmUp = 1;
+
+	// no list yet, the pool starts cold
+	CHECK(initBufferPoolWithOptions(bm, TESTPF, 6, RS_LRU, NULL, &options));
+	ASSERT_EQUALS_INT(0, waitForReads(bm, 1), "nothing to warm up from");
+	for (i = 15; i >= 10; i--)
+	{
+		TEST_CHECK(pinPage(bm, &handles[i - 10], i));
+		checkDummyPage(&handles[i - 10], i);
+	}
+	for (i = 0; i < 6; i++)
+		TEST_CHECK(unpinPage(bm, &handles[i]));
+	CHECK(shutdownBufferPool(bm));
+
+	// the six pages are loaded again in page number order, pinning them reads nothing
+	CHECK(initBufferPoolWithOptions(bm, TESTPF, 6, RS_LRU, NULL, &options));
+	ASSERT_EQUALS_INT(6, waitForReads(bm, 6), "the resident pages are read back");
+	frameContents = getFrameContents(bm);
+	for (i = 0; i < 6; i++)
+		ASSERT_EQUALS_INT(10 + i, (int)frameContents[i], "pages are loaded in page number order");
+	free(frameContents);
+	for (i = 10; i < 16; i++)
+	{
+		TEST_CHECK(pinPage(bm, h, i));
+		checkDummyPage(h, i);
+		TEST_CHECK(unpinPage(bm, h));
+	}
+	ASSERT_EQUALS_INT(6, getNumReadIO(bm), "no page is read by the pins");
+	CHECK(shutdownBufferPool(bm));
+
+	// a smaller pool takes the lowest pages of the list, a pool without warm-up ignores it
+	CHECK(initBufferPoolWithOptions(bm, TESTPF, 3, RS_LRU, NULL, &options));
+	ASSERT_EQUALS_INT(3, waitForReads(bm, 3), "three pages fit the pool");
+	frameContents = getFrameContents(bm);
+	for (i = 0; i < 3; i++)
+		ASSERT_EQUALS_INT(10 + i, (int)frameContents[i], "the lowest pages are loaded");
+	free(frameContents);
+	CHECK(shutdownBufferPool(bm));
+	CHECK(initBufferPool(bm, TESTPF, 6, RS_LRU, NULL));
+	usleep(50000);
+	ASSERT_EQUALS_INT(0, getNumReadIO(bm), "the list is ignored without warm-up");
+	CHECK(shutdownBufferPool(bm));
+
+	// detach saves the list of an attached file, attach loads at most half the pool from it
+	CHECK(initBufferPoolWithOptions(bm, NULL, 6, RS_LRU, NULL, &options));
+	TEST_CHECK(attachPageFile(bm, TESTPF, &fileId));
+	ASSERT_EQUALS_INT(3, waitForReads(bm, 3), "the attached file is warmed up");
+	for (i = 4; i < 6; i++)
+	{
+		TEST_CHECK(pinFilePage(bm, fileId, h, i));
+		TEST_CHECK(unpinPage(bm, h));
+	}
+	TEST_CHECK(detachPageFile(bm, fileId));
+	numReads = getNumReadIO(bm);
+	TEST_CHECK(attachPageFile(bm, TESTPF, &fileId));
+	ASSERT_EQUALS_INT(numReads + 3, waitForReads(bm, numReads + 3), "half the pool is warmed up");
+	frameContents = getFrameContents(bm);
+	for (i = 0; i < 6; i++)
+		ASSERT_TRUE(frameContents[i] == NO_PAGE || frameContents[i] == 4 || frameContents[i] == 5 || frameContents[i] == 10,
+				"the pages of the last detach are loaded");
+	free(frameContents);
+	TEST_CHECK(detachPageFile(bm, fileId));
+	CHECK(shutdownBufferPool(bm));
+
+	TEST_CHECK(destroyWarmUpList(TESTPF));
+	ASSERT_TRUE(destroyWarmUpList(TESTPF) == RC_FILE_NOT_FOUND, "the list is gone");
+	CHECK(destroyPageFile(TESTPF));
+	free(bm);
+	free(h);
+	TEST_DONE();
+}
@@ -55,6 +55,7 @@ static void testScans (void);
 static void testScansTwo (void);
 static void testInsertManyRecords(void);
 static void testMultipleScans(void);
+static void testTwoOpenTables(void);
 
 // struct for test records
 typedef struct TestRecord {
@@ -77,6 +78,7 @@ main (void)
 {
 	testName = "";
 
+	testTwoOpenTables();
 	testInsertManyRecords();
 	testRecords();
 	testCreateTableAndInsert();
@@ -270,6 +272,72 @@ testMultipleScans(void)
 	TEST_DONE();
 }
 
+// tables open at the same time share the buffer pool but keep their own pages
+void
+testTwoOpenTables(void)
+{
+	RM_TableData *tables[2];
+	TestRecord inserts[] = {
+			{1, "aaaa", 3},
+			{2, "bbbb", 2},
+			{3, "cccc", 1},
+			{4, "dddd", 3},
+			{5, "eeee", 5}
+	};
+	char *names[] = { "test_table_r", "test_table_s" };
+	int numInserts[] = { 2, 5 };
+	int i, t, count, rc;
+	Record *r;
+	Schema *schema;
+	RM_ScanHandle *sc = (RM_ScanHandle *) malloc(sizeof(RM_ScanHandle));
+	testName = "test inserting into and scanning two open tables";
+	schema = testSchema();
+
+	TEST_CHECK(initRecordManager(NULL));
+	for (t = 0; t < 2; t++)
+	{
+		tables[t] = (RM_TableData *) malloc(sizeof(RM_TableData));
+		TEST_CHECK(createTable(names[t], schema));
+		TEST_CHECK(openTable(tables[t], names[t]));
+	}
+
+	// the inserts alternate between the tables
+	for (i = 0; i < 5; i++)
+		for (t = 0; t < 2; t++)
+			if (i < numInserts[t])
+			{
+				r = fromTestRecord(schema, inserts[i]);
+				TEST_CHECK(insertRecord(tables[t], r));
+				ASSERT_EQUALS_INT(i + 1, (int)r->id.page, "each table fills its own pages");
+				freeRecord(r);
+			}
+
+	createRecord(&r, schema);
+	for (t = 0; t < 2; t++)
+	{
+		count = 0;
+		TEST_CHECK(startScan(tables[t], sc, NULL));
+		while ((rc = next(sc, r)) == RC_OK)
+			count++;
+		ASSERT_EQUALS_INT(RC_RM_NO_MORE_TUPLES, rc, "scan ends after the last tuple");
+		ASSERT_EQUALS_INT(numInserts[t], count, "the scan sees the table's own tuples");
+		TEST_CHECK(closeScan(sc));
+	}
+
+	for (t = 0; t < 2; t++)
+	{
+		TEST_CHECK(closeTable(tables[t]));
+		TEST_CHECK(deleteTable(names[t]));
+		free(tables[t]);
+	}
+	TEST_CHECK(shutdownRecordManager());
+
+	freeRecord(r);
+	free(sc);
+	freeSchema(schema);
+	TEST_DONE();
+}
+
 void 
 testUpdateTable (void)
 {